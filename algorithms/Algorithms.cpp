@@ -1,46 +1,85 @@
 #include "Algorithms.h"
 
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
 
 
-void dijkstra(const Graph * g, const int &origin, const int &dest, const int mode, const double maxWalkTime, Vertex **u) {
 
-    //graph is already initialized to perform this algorithm
+namespace {
 
-    //get the origin
-    Vertex* s = g->findVertex(origin);
-    s->setDist(0, mode);
+// The search loop of dijkstra(...), compiled once per queue, mode and feature: Mode is DRIVING or WALKING and
+// TrackPark tells whether the best parking spot is kept in *u, so none of them is tested inside the loop.
+template <class Queue, int Mode, bool TrackPark>
+void search(const CSRGraph &csr, SearchContext &ctx, const int s, const int dest, const double maxWalkTime, int *u,
+            const std::vector<int> *parks, ParkCandidates *candidates) {
+
+    //the bucket queue runs on the integer times
+    constexpr bool integer = std::is_same_v<Queue, BucketQueue>;
+
+    if constexpr (integer) {
+        ctx.fitMinutes<Mode>();
+        ctx.setMinutes<Mode>(s, 0, -1);
+    } else {
+        ctx.set<Mode>(s, 0, -1);
+    }
 
     //initialize a priority queue and add origin to it
-    MutablePriorityQueue<Vertex> q;
+    Queue q = [&] {
+        if constexpr (integer) return Queue(ctx.layer<Mode>().minutes, csr.maxMinutes(Mode));
+        else return Queue(ctx.layer<Mode>().dist, ctx.queueIndex);
+    }();
     q.insert(s);
+    size_t next = 0; // first of the parks that may not be settled yet
 
     while (!q.empty()) {
 
-        Vertex *v = q.extractMin();
+        int v = q.extractMin();
 
 
-        if (v->getId() == dest) { //early out if destiny reached
+        if (csr.id(v) == dest) { //early out if destiny reached
             break;
         }
 
-        if (mode == 0 && v->isPark() && (u != nullptr || maxWalkTime != -1)) {
-            *u = betterPark(*u, v, maxWalkTime) ? *u : v;
+        if constexpr (TrackPark) {
+            if (parks != nullptr) {
+                // Every park left is settled at v's driving time or later, so it takes at least that plus the
+                // shortest walk among them. It only replaces *u if its total is not greater, as in betterPark
+                const double d = ctx.getDist<DRIVING>(v);
+                while (next < parks->size() && ctx.getDist<DRIVING>((*parks)[next]) < d) next++;
+                if (next == parks->size()) break;
+                if (csr.isPark(*u) && d + ctx.getDist<WALKING>((*parks)[next]) > ctx.getDist<DRIVING>(*u) + ctx.getDist<WALKING>(*u)) {
+                    break;
+                }
+            }
+            if (csr.isPark(v)) {
+                *u = betterPark(csr, ctx, *u, v, maxWalkTime) ? *u : v;
+                if (candidates != nullptr && ctx.getDist<WALKING>(v) != INF) {
+                    candidates->offer(v, ctx.getDist<DRIVING>(v) + ctx.getDist<WALKING>(v));
+                }
+            }
         }
-        if (mode==1 && v->getDist(mode) > maxWalkTime) {
-            return;
+        if constexpr (Mode == WALKING) {
+            if (ctx.getDist<Mode>(v) > maxWalkTime) {
+                return;
+            }
         }
 
-        for (auto e : v->getAdj()) {
+        for (int e : csr.edges(v)) {
 
-            if (e->isAvoiding() || e->getTime(mode)==-1) {continue;}
-            Vertex *w = e->getDest();
+            if (ctx.avoidEdge.test(e) || csr.time<Mode>(e)==-1) {continue;}
+            int w = csr.target(e);
 
-            if (w->isAvoiding() || w->isVisited()) {
+            if (ctx.avoidNode.test(w) || ctx.isVisited(w)) {
                 continue;
             } //skips vertex that were used in the first route (visited) + the ones to avoid
 
-            double oldDist = w->getDist(mode);;
-            if (relax(e, mode)) {
+            double oldDist = ctx.getDist<Mode>(w);
+            bool relaxed;
+            if constexpr (integer) relaxed = relaxMinutes<Mode>(csr, ctx, e);
+            else relaxed = relax<Mode>(csr, ctx, e);
+            if (relaxed) {
                 if (oldDist == INF) {
                     q.insert(w);
                 }else {
@@ -51,10 +90,596 @@ void dijkstra(const Graph * g, const int &origin, const int &dest, const int mod
     }
 }
 
+}
+
+template <class Queue>
+void dijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int mode, const double maxWalkTime, int *u,
+              const std::vector<int> *parks, ParkCandidates *candidates) {
+
+    //graph is already initialized to perform this algorithm
+    const CSRGraph &csr = g->getCSR();
+
+    //get the origin
+    int s = g->findVertexIndex(origin);
+
+    //the only run time checks on the mode and the parking spot, everything else is chosen at compile time
+    if (mode == WALKING) {
+        search<Queue, WALKING, false>(csr, ctx, s, dest, maxWalkTime, u, nullptr, nullptr);
+    } else if (u != nullptr) {
+        search<Queue, DRIVING, true>(csr, ctx, s, dest, maxWalkTime, u, parks, candidates);
+    } else {
+        search<Queue, DRIVING, false>(csr, ctx, s, dest, maxWalkTime, u, nullptr, nullptr);
+    }
+}
+
+template void dijkstra<IndexedPriorityQueue>(const Graph *, SearchContext &, const int &, const int &, int, double, int *,
+                                  const std::vector<int> *, ParkCandidates *);
+template void dijkstra<DaryHeap>(const Graph *, SearchContext &, const int &, const int &, int, double, int *,
+                                  const std::vector<int> *, ParkCandidates *);
+template void dijkstra<RadixHeap>(const Graph *, SearchContext &, const int &, const int &, int, double, int *,
+                                  const std::vector<int> *, ParkCandidates *);
+template void dijkstra<BucketQueue>(const Graph *, SearchContext &, const int &, const int &, int, double, int *,
+                                  const std::vector<int> *, ParkCandidates *);
+
+void dijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int mode, const double maxWalkTime,
+              int *u, const QueueKind queue, const std::vector<int> *parks, ParkCandidates *candidates) {
+    switch (queue) {
+        case QueueKind::Dary: dijkstra<DaryHeap>(g, ctx, origin, dest, mode, maxWalkTime, u, parks, candidates); break;
+        case QueueKind::Radix: dijkstra<RadixHeap>(g, ctx, origin, dest, mode, maxWalkTime, u, parks, candidates); break;
+        case QueueKind::Bucket:
+            if (g->getCSR().isIntegral()) {
+                dijkstra<BucketQueue>(g, ctx, origin, dest, mode, maxWalkTime, u, parks, candidates);
+                break;
+            }
+            [[fallthrough]];
+        default: dijkstra<IndexedPriorityQueue>(g, ctx, origin, dest, mode, maxWalkTime, u, parks, candidates); break;
+    }
+}
+
+
+namespace {
+
+// Both halves of bidirectionalDijkstra(...). The forward search uses the layer of Mode and the backward one
+// ctx.back, whose path entries are the next edge towards the destination.
+template <int Mode>
+void bidirectionalSearch(const CSRGraph &csr, SearchContext &ctx, const int s, const int t) {
+    SearchContext::Layer &fwd = ctx.layer<Mode>();
+    SearchContext::Layer &bwd = ctx.back;
+    SearchContext::reset(bwd);
+
+    // Same restrictions as dijkstra: every vertex but the origin must not be avoided nor visited
+    auto usable = [&](int w) { return w == s || (!ctx.avoidNode.test(w) && !ctx.isVisited(w)); };
+    auto dist = [](const SearchContext::Layer &l, int v) { return l.stamp[v] == l.epoch ? l.dist[v] : INF; };
+    auto set = [](SearchContext::Layer &l, int v, double d, int e) { l.dist[v] = d; l.path[v] = e; l.stamp[v] = l.epoch; };
+
+    ctx.set<Mode>(s, 0, -1);
+    if (s == t || !usable(t))
+        return;
+    set(bwd, t, 0, -1);
+
+    IndexedPriorityQueue qf(fwd.dist, ctx.queueIndex), qb(bwd.dist, ctx.backQueueIndex);
+    qf.insert(s);
+    qb.insert(t);
+
+    double best = INF; // length of the shortest path found so far
+    int meet = -1;     // its middle edge, from the forward to the backward tree
+
+    // Stop once no path through an unsettled vertex can be shorter than the best one
+    while (!qf.empty() && !qb.empty() && fwd.dist[qf.top()] + bwd.dist[qb.top()] < best) {
+        if (fwd.dist[qf.top()] <= bwd.dist[qb.top()]) {
+            int v = qf.extractMin();
+            for (int e : csr.edges(v)) {
+                if (ctx.avoidEdge.test(e) || csr.time<Mode>(e) == -1) continue;
+                int w = csr.target(e);
+                if (!usable(w)) continue;
+                double d = fwd.dist[v] + csr.time<Mode>(e);
+                if (d < dist(fwd, w)) {
+                    bool inQueue = dist(fwd, w) != INF;
+                    set(fwd, w, d, e);
+                    inQueue ? qf.decreaseKey(w) : qf.insert(w);
+                }
+                if (dist(bwd, w) != INF && d + dist(bwd, w) < best) {
+                    best = d + dist(bwd, w);
+                    meet = e;
+                }
+            }
+        } else {
+            int v = qb.extractMin();
+            for (int e : csr.incoming(v)) {
+                if (ctx.avoidEdge.test(e) || csr.time<Mode>(e) == -1) continue;
+                int w = csr.source(e);
+                if (!usable(w)) continue;
+                double d = bwd.dist[v] + csr.time<Mode>(e);
+                if (d < dist(bwd, w)) {
+                    bool inQueue = dist(bwd, w) != INF;
+                    set(bwd, w, d, e);
+                    inQueue ? qb.decreaseKey(w) : qb.insert(w);
+                }
+                if (dist(fwd, w) != INF && dist(fwd, w) + d < best) {
+                    best = dist(fwd, w) + d;
+                    meet = e;
+                }
+            }
+        }
+    }
+    if (meet == -1)
+        return;
+
+    // Extend the forward tree along the backward one, so the path reads as if dijkstra had reached t
+    for (int e = meet; e != -1; e = bwd.path[csr.target(e)]) {
+        ctx.set<Mode>(csr.target(e), ctx.getDist<Mode>(csr.source(e)) + csr.time<Mode>(e), e);
+    }
+}
+
+// A* from s to t with the landmark lower bounds as potentials. They are consistent, so as in dijkstra every
+// vertex is settled once and the search stops when t is settled.
+template <int Mode>
+void altSearch(const CSRGraph &csr, SearchContext &ctx, const LandmarkTable &landmarks, const int s, const int t) {
+    ctx.set<Mode>(s, 0, -1);
+    ctx.estimate[s] = landmarks.lowerBound<Mode>(s, t);
+    IndexedPriorityQueue q(ctx.estimate, ctx.queueIndex);
+    q.insert(s);
+
+    while (!q.empty()) {
+        int v = q.extractMin();
+        if (v == t) {
+            break;
+        }
+        for (int e : csr.edges(v)) {
+            if (ctx.avoidEdge.test(e) || csr.time<Mode>(e) == -1) continue;
+            int w = csr.target(e);
+            if (ctx.avoidNode.test(w) || ctx.isVisited(w)) continue;
+
+            double oldDist = ctx.getDist<Mode>(w);
+            if (relax<Mode>(csr, ctx, e)) {
+                ctx.estimate[w] = ctx.getDist<Mode>(w) + landmarks.lowerBound<Mode>(w, t);
+                if (oldDist == INF) {
+                    q.insert(w);
+                } else {
+                    q.decreaseKey(w);
+                }
+            }
+        }
+    }
+}
+
+}
+
+void altDijkstra(const Graph * g, SearchContext &ctx, const LandmarkTable &landmarks, const int &origin, const int &dest, const int mode) {
+    const CSRGraph &csr = g->getCSR();
+    int s = g->findVertexIndex(origin);
+    int t = g->findVertexIndex(dest);
+    if (mode == WALKING) {
+        altSearch<WALKING>(csr, ctx, landmarks, s, t);
+    } else {
+        altSearch<DRIVING>(csr, ctx, landmarks, s, t);
+    }
+}
+
+// Replaces the labels of a hierarchy query by its route, as if dijkstra had found it
+static void writeRoute(const CSRGraph &csr, SearchContext &ctx, const int s, const std::vector<int> &route) {
+    ctx.resetDist(DRIVING);
+    ctx.set<DRIVING>(s, 0, -1);
+    for (int e : route) {
+        ctx.set<DRIVING>(csr.target(e), ctx.getDist<DRIVING>(csr.source(e)) + csr.drive(e), e);
+    }
+}
+
+void hierarchyDijkstra(const Graph * g, SearchContext &ctx, const ContractionHierarchy &hierarchy, const int &origin, const int &dest) {
+    int s = g->findVertexIndex(origin);
+    std::vector<int> route;
+    hierarchy.query(ctx, s, g->findVertexIndex(dest), route);
+    writeRoute(g->getCSR(), ctx, s, route);
+}
+
+void customizableDijkstra(const Graph * g, SearchContext &ctx, const CustomizableHierarchy &hierarchy, const HierarchyMetric &metric,
+                          const int &origin, const int &dest) {
+    int s = g->findVertexIndex(origin);
+    std::vector<int> route;
+    hierarchy.query(ctx, metric, s, g->findVertexIndex(dest), route);
+    writeRoute(g->getCSR(), ctx, s, route);
+}
+
+void matrixRoute(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int mode) {
+    const CSRGraph &csr = g->getCSR();
+    const int s = g->findVertexIndex(origin);
+    ctx.resetDist(mode);
+    ctx.set(s, 0, -1, mode);
+    for (int v = g->findVertexIndex(dest), e; v != s && (e = g->getMatrixPath(s, v, mode)) != -1; v = csr.source(e)) {
+        ctx.set(v, g->getMatrixDist(s, v, mode), e, mode);
+    }
+}
+
+// Best parking spot for DrivingWalking by the all-pairs matrices. The parks are compared in order of driving
+// time, as dijkstra(...) settles them, so ties are broken as in the search except between parks at the same
+// driving time.
+static int matrixPark(const Graph * g, const int s, const int t, const double maxWalkTime) {
+    const CSRGraph &csr = g->getCSR();
+    std::vector<int> parks;
+    for (int v = 0; v < csr.numVertices(); v++) {
+        if (csr.isPark(v) && g->getMatrixDist(s, v, DRIVING) != INF) parks.push_back(v);
+    }
+    std::ranges::stable_sort(parks, {}, [&](int v) { return g->getMatrixDist(s, v, DRIVING); });
+
+    int u = s;
+    for (int v : parks) {
+        const bool keep = betterPark(csr.isPark(u), g->getMatrixDist(s, u, DRIVING), g->getMatrixDist(t, u, WALKING),
+                                     g->getMatrixDist(s, v, DRIVING), g->getMatrixDist(t, v, WALKING), maxWalkTime);
+        u = keep ? u : v;
+    }
+    return u;
+}
+
+int parkingSearch(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const double maxWalkTime) {
+    const CSRGraph &csr = g->getCSR();
+    const int s = g->findVertexIndex(origin);
+    const int t = g->findVertexIndex(dest);
+
+    // A walking label is a route origin -> park -> vertex: its total time and its walking part. Labels of a vertex
+    // form a list whose head is kept in the walking layer (path = first label, dist = smallest total).
+    struct Label {
+        double total, walk;
+        int vertex;
+        int parent;  // previous label on the walk, -1 at the park
+        int edge;    // edge walked backwards from the previous label, -1 at the park
+        int next;    // next label of the same vertex
+    };
+    // Walking labels waiting to be settled, the fastest first and, among equal totals, the shortest walk
+    struct Entry {
+        double total, walk;
+        int label;
+        bool operator>(const Entry &o) const { return total != o.total ? total > o.total : walk > o.walk; }
+    };
+    std::vector<Label> labels;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> walkQueue;
+    SearchContext::Layer &walk = ctx.walk;
+    ctx.resetDist(DRIVING);
+    ctx.resetDist(WALKING);
+
+    // A label is kept unless another one at the vertex is neither slower nor longer
+    auto addLabel = [&](int v, double total, double w, int parent, int edge) {
+        const bool listed = walk.stamp[v] == walk.epoch;
+        for (int l = listed ? walk.path[v] : -1; l != -1; l = labels[l].next) {
+            if (labels[l].total <= total && labels[l].walk <= w)
+                return;
+        }
+        labels.push_back({total, w, v, parent, edge, listed ? walk.path[v] : -1});
+        const int l = static_cast<int>(labels.size()) - 1;
+        ctx.set<WALKING>(v, listed ? std::min(walk.dist[v], total) : total, l);
+        walkQueue.push({total, w, l});
+    };
+
+    ctx.set<DRIVING>(s, 0, -1);
+    IndexedPriorityQueue driveQueue(ctx.drive.dist, ctx.queueIndex);
+    driveQueue.insert(s);
+    int found = -1;
+    while (!driveQueue.empty() || !walkQueue.empty()) {
+
+        // Driving layer: a plain dijkstra from the origin; each settled parking spot starts a walk
+        if (walkQueue.empty() || (!driveQueue.empty() && ctx.drive.dist[driveQueue.top()] < walkQueue.top().total)) {
+            const int v = driveQueue.extractMin();
+            if (csr.isPark(v)) addLabel(v, ctx.getDist<DRIVING>(v), 0, -1, -1);
+            for (int e : csr.edges(v)) {
+                if (ctx.avoidEdge.test(e) || csr.drive(e) == -1) continue;
+                const int w = csr.target(e);
+                if (ctx.avoidNode.test(w)) continue;
+                const double oldDist = ctx.getDist<DRIVING>(w);
+                if (relax<DRIVING>(csr, ctx, e)) {
+                    if (oldDist == INF) driveQueue.insert(w);
+                    else driveQueue.decreaseKey(w);
+                }
+            }
+            continue;
+        }
+
+        // Walking layer: the edges are walked backwards, as in the walking dijkstra from the destination
+        const Entry top = walkQueue.top();
+        walkQueue.pop();
+        const int v = labels[top.label].vertex;
+        if (v == t) {
+            found = top.label;
+            break;
+        }
+        for (int e : csr.incoming(v)) {
+            if (ctx.avoidEdge.test(e) || csr.walk(e) == -1) continue;
+            const int w = csr.source(e);
+            if (w != t && ctx.avoidNode.test(w)) continue;
+            const double walked = top.walk + csr.walk(e);
+            if (walked > maxWalkTime) continue;
+            addLabel(w, top.total + csr.walk(e), walked, top.label, e);
+        }
+    }
+    if (found == -1)
+        return -1;
+
+    // Leave the walk in the walking layer as a tree from the destination, as dijkstra(...) would
+    int l = found;
+    while (labels[l].parent != -1) l = labels[l].parent;
+    const int park = labels[l].vertex;
+    ctx.resetDist(WALKING);
+    ctx.set<WALKING>(t, 0, -1);
+    for (l = found; labels[l].parent != -1; l = labels[l].parent) {
+        const int e = labels[l].edge;
+        ctx.set<WALKING>(csr.target(e), labels[found].walk - labels[labels[l].parent].walk, e);
+    }
+    return park;
+}
+
+void bidirectionalDijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int mode) {
+    const CSRGraph &csr = g->getCSR();
+    int s = g->findVertexIndex(origin);
+    int t = g->findVertexIndex(dest);
+    if (mode == WALKING) {
+        bidirectionalSearch<WALKING>(csr, ctx, s, t);
+    } else {
+        bidirectionalSearch<DRIVING>(csr, ctx, s, t);
+    }
+}
+
+// Runs the point-to-point search of SimpleDriving and RestrictedDriving. Returns whether it was dijkstra(...), which
+// leaves the whole tree of its search in the layer and not just the route
+static bool pointToPoint(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int mode, const QueueKind queue) {
+    if (ctx.engines->landmarks != nullptr) {
+        altDijkstra(g, ctx, *ctx.engines->landmarks, origin, dest, mode);
+    } else if (ctx.engines->bidirectional) {
+        bidirectionalDijkstra(g, ctx, origin, dest, mode);
+    } else {
+        dijkstra(g, ctx, origin, dest, mode, -1, nullptr, queue);
+        return true;
+    }
+    return false;
+}
+
+// Arcs of the residual graph of residualRoutes(...), kept in the int path entries of its layers: an edge id, an edge
+// of P walked backwards, or the step from the out copy of a vertex to its in copy.
+struct ResidualArc {
+    static constexpr int SPLIT = std::numeric_limits<int>::max();
+    static int backward(int e) { return -2 - e; }
+    static bool isBackward(int arc) { return arc <= -2; }
+    static int edgeOf(int arc) { return isBackward(arc) ? -2 - arc : arc; }
+};
+
+// Second pass of disjointRoutes(...). The driving layer holds a dijkstra from s stopped once t was settled, and the
+// inner vertices of its route P are marked as visited.
+static void residualRoutes(const CSRGraph &csr, SearchContext &ctx, const int s, const int t, std::vector<int> &first,
+                           std::vector<int> &second) {
+    first.clear();
+    second.clear();
+    const double D = ctx.getDist<DRIVING>(t);
+
+    // Potentials: the settled distances of the first pass are exact and every other vertex is at least D away, so
+    // min(dist, D) keeps every reduced cost non-negative and makes the edges of P tight
+    auto potential = [&](int v) { return std::min(ctx.getDist<DRIVING>(v), D); };
+    auto onP = [&](int e) {
+        const int w = csr.target(e);
+        return (w == t || ctx.isVisited(w)) && ctx.getPath(w, DRIVING) == e;
+    };
+
+    // Second pass, in the residual graph of P with its inner vertices split in two: an edge into such a vertex v
+    // reaches v_in (layer back), whose only way out is P walked backwards to the out copy of the previous vertex
+    // (layer walk, shared with the vertices off P); v_out can go on backwards through v_in at no cost.
+    SearchContext::Layer &out = ctx.walk, &in = ctx.back;
+    SearchContext::reset(out);
+    SearchContext::reset(in);
+    auto dist = [](const SearchContext::Layer &l, int v) { return l.stamp[v] == l.epoch ? l.dist[v] : INF; };
+    IndexedPriorityQueue qo(out.dist, ctx.queueIndex), qi(in.dist, ctx.backQueueIndex);
+    auto relax = [&](bool toIn, int w, double d, int arc) {
+        SearchContext::Layer &l = toIn ? in : out;
+        IndexedPriorityQueue &q = toIn ? qi : qo;
+        if (d >= dist(l, w)) return;
+        const bool inQueue = dist(l, w) != INF;
+        l.dist[w] = d;
+        l.path[w] = arc;
+        l.stamp[w] = l.epoch;
+        inQueue ? q.decreaseKey(w) : q.insert(w);
+    };
+
+    relax(false, s, 0, -1);
+    while (!qo.empty() || !qi.empty()) {
+        const bool isIn = qo.empty() || (!qi.empty() && in.dist[qi.top()] < out.dist[qo.top()]);
+        const int v = isIn ? qi.extractMin() : qo.extractMin();
+        if (!isIn && v == t) break;
+        if (isIn) {
+            const int e = ctx.getPath(v, DRIVING); // reduced cost 0
+            if (csr.source(e) != s) relax(false, csr.source(e), in.dist[v], ResidualArc::backward(e));
+            continue;
+        }
+        if (ctx.isVisited(v)) relax(true, v, out.dist[v], ResidualArc::SPLIT);
+        for (int e : csr.edges(v)) {
+            if (ctx.avoidEdge.test(e) || csr.drive(e) == -1 || onP(e)) continue;
+            const int w = csr.target(e);
+            if (w == s || ctx.avoidNode.test(w)) continue;
+            const double reduced = std::max(0.0, csr.drive(e) + potential(v) - potential(w));
+            relax(ctx.isVisited(w), w, out.dist[v] + reduced, e);
+        }
+    }
+
+    // Edges of P and of the second route Q, less those of P that Q walks backwards
+    std::vector<int> chosen;
+    if (dist(out, t) != INF) {
+        std::vector<int> cancel;
+        for (int v = t, isIn = 0; isIn || v != s;) {
+            const int arc = isIn ? in.path[v] : out.path[v];
+            if (arc == ResidualArc::SPLIT) {
+                isIn = 0;
+            } else if (ResidualArc::isBackward(arc)) {
+                cancel.push_back(ResidualArc::edgeOf(arc));
+                v = csr.target(ResidualArc::edgeOf(arc));
+                isIn = 1;
+            } else {
+                chosen.push_back(arc);
+                v = csr.source(arc);
+                isIn = 0;
+            }
+        }
+        for (int v = t; v != s; v = csr.source(ctx.getPath(v, DRIVING))) {
+            const int e = ctx.getPath(v, DRIVING);
+            if (std::ranges::find(cancel, e) == cancel.end()) chosen.push_back(e);
+        }
+    }
+    if (chosen.empty()) {
+        // No second route: P alone
+        for (int v = t; v != s; v = csr.source(ctx.getPath(v, DRIVING)))
+            first.push_back(ctx.getPath(v, DRIVING));
+        std::ranges::reverse(first);
+        return;
+    }
+
+    // Every vertex but s and t leaves by one chosen edge, so the two routes are read from the two edges out of s
+    auto bySource = [&](int e) { return csr.source(e); };
+    std::ranges::sort(chosen, {}, bySource);
+    const auto fromS = std::ranges::lower_bound(chosen, s, {}, bySource);
+    double times[2] = {0, 0};
+    for (int i = 0; i < 2; i++) {
+        std::vector<int> &route = i == 0 ? first : second;
+        for (int e = fromS[i];; e = *std::ranges::lower_bound(chosen, csr.target(e), {}, bySource)) {
+            route.push_back(e);
+            times[i] += csr.drive(e);
+            if (csr.target(e) == t) break;
+        }
+    }
+    if (times[1] < times[0]) {
+        std::swap(first, second);
+    }
+}
+
+// Upper bound on the reachability checks of tightRoutes(...), each O(V + E)
+constexpr int MAX_TIGHT_CHECKS = 256;
+
+// Whether two route times are equal up to rounding: the engines add the same edge times in different orders
+// (forward and backward halves, matrix compositions), which may differ in the last bits when they are not whole
+static bool sameTime(const double a, const double b) {
+    return std::abs(a - b) <= 1e-9 * std::max({1.0, std::abs(a), std::abs(b)});
+}
+
+// Whether an edge may be driven in the query of ctx
+static bool drivable(const CSRGraph &csr, const SearchContext &ctx, const int e) {
+    return !ctx.avoidEdge.test(e) && csr.drive(e) != -1 && !ctx.avoidNode.test(csr.target(e));
+}
+
+// Whether t can be reached from s without the vertices marked as visited. Uses the back layer as the seen flags
+static bool reachable(const CSRGraph &csr, SearchContext &ctx, const int s, const int t) {
+    SearchContext::Layer &seen = ctx.back;
+    SearchContext::reset(seen);
+    seen.stamp[s] = seen.epoch;
+    std::vector<int> stack = {s};
+    while (!stack.empty()) {
+        const int v = stack.back();
+        stack.pop_back();
+        for (int e : csr.edges(v)) {
+            const int w = csr.target(e);
+            if (!drivable(csr, ctx, e) || seen.stamp[w] == seen.epoch || (w != t && ctx.isVisited(w))) continue;
+            if (w == t) return true;
+            seen.stamp[w] = seen.epoch;
+            stack.push_back(w);
+        }
+    }
+    return false;
+}
+
+// The edges of every fastest route of the first pass of disjointRoutes(...), sorted by origin: the edges u->v with
+// dist(u) + time == dist(v) from which t can be reached by such edges
+static std::vector<int> tightEdges(const CSRGraph &csr, SearchContext &ctx, const int t) {
+    std::vector<int> tight;
+    SearchContext::Layer &seen = ctx.back;
+    SearchContext::reset(seen);
+    seen.stamp[t] = seen.epoch;
+    std::vector<int> stack = {t};
+    while (!stack.empty()) {
+        const int v = stack.back();
+        stack.pop_back();
+        for (int e : csr.incoming(v)) {
+            const int u = csr.source(e);
+            if (!drivable(csr, ctx, e) || !sameTime(ctx.getDist<DRIVING>(u) + csr.drive(e), ctx.getDist<DRIVING>(v))) continue;
+            tight.push_back(e);
+            if (seen.stamp[u] != seen.epoch) {
+                seen.stamp[u] = seen.epoch;
+                stack.push_back(u);
+            }
+        }
+    }
+    std::ranges::sort(tight, {}, [&](int e) { return csr.source(e); });
+    return tight;
+}
+
+// A pair for SimpleDriving when the pair of residualRoutes(...) is slower than the fastest route: a fastest route
+// whose inner vertices do not cut t from s, and the fastest route without them. Deciding if one exists is NP-hard
+// in general (the min-min disjoint paths problem), so the fastest routes are walked depth first, dropping a prefix
+// as soon as its vertices cut t from s, for at most MAX_TIGHT_CHECKS checks. The driving layer must hold the first
+// pass of disjointRoutes(...); it is overwritten by the second route.
+static bool tightRoutes(const Graph * g, SearchContext &ctx, const int s, const int t, std::vector<int> &first,
+                        std::vector<int> &second) {
+    const CSRGraph &csr = g->getCSR();
+    const std::vector<int> tight = tightEdges(csr, ctx, t);
+    auto from = [&](int u) {
+        return std::ranges::lower_bound(tight, u, {}, [&](int e) { return csr.source(e); }) - tight.begin();
+    };
+
+    // route is the prefix being tried and next[i] the next tight edge to try from its i-th vertex. A direct segment
+    // is never tried: SimpleDriving's own second search takes it again
+    ctx.resetVisited();
+    std::vector<int> route;
+    std::vector<std::ptrdiff_t> next = {from(s)};
+    bool found = false;
+    for (int checks = 0; !found && !next.empty() && checks < MAX_TIGHT_CHECKS;) {
+        const int u = route.empty() ? s : csr.target(route.back());
+        std::ptrdiff_t &i = next.back();
+        if (i == static_cast<std::ptrdiff_t>(tight.size()) || csr.source(tight[i]) != u) {
+            next.pop_back();
+            if (!route.empty()) {
+                ctx.clearVisited(u);
+                route.pop_back();
+            }
+            continue;
+        }
+        const int e = tight[i++];
+        const int w = csr.target(e);
+        if (w == t) {
+            found = !route.empty(); // the prefix was checked when its last vertex was added
+            if (found) route.push_back(e);
+            continue;
+        }
+        ctx.setVisited(w);
+        checks++;
+        if (!reachable(csr, ctx, s, t)) {
+            ctx.clearVisited(w);
+            continue;
+        }
+        route.push_back(e);
+        next.push_back(from(w));
+    }
+    if (!found) return false;
+
+    // Only the inner vertices of the route are marked, so the search below finds the fastest route without them
+    ctx.resetDist(DRIVING);
+    dijkstra(g, ctx, csr.id(s), csr.id(t), DRIVING, -1, nullptr, ctx.engines->queues.simpleDriving);
+    first = std::move(route);
+    second.clear();
+    for (int v = t; v != s; v = csr.source(ctx.getPath(v, DRIVING)))
+        second.push_back(ctx.getPath(v, DRIVING));
+    std::ranges::reverse(second);
+    return true;
+}
 
+void disjointRoutes(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, std::vector<int> &first,
+                    std::vector<int> &second) {
+    const int s = g->findVertexIndex(origin);
+    const int t = g->findVertexIndex(dest);
+    first.clear();
+    second.clear();
+
+    // First pass: the fastest route P, whose inner vertices getPath marks as visited
+    ctx.resetDist(DRIVING);
+    ctx.resetVisited();
+    dijkstra(g, ctx, origin, dest, DRIVING, -1, nullptr, ctx.engines->queues.simpleDriving);
+    double time = 0;
+    if (s == t || getPath(g, ctx, origin, dest, time, DRIVING).empty())
+        return;
+    residualRoutes(g->getCSR(), ctx, s, t, first, second);
+}
 
 // Fastest Route + Independent Route Planning
-std::string SimpleDriving(Graph * g, const int &origin, const int &dest) {
+std::string SimpleDriving(const Graph * g, SearchContext &ctx, const int &origin, const int &dest) {
     int mode = 0; //driving mode
 
     std::ostringstream oss;
@@ -62,12 +687,20 @@ std::string SimpleDriving(Graph * g, const int &origin, const int &dest) {
 
     // Initialize all nodes to perform the Dijkstra algorithm
     // Visited set to false
-    initAvoid(g,{},{}, mode);
-    dijkstra(g, origin, dest, mode); //perform dijkstra
+    initAvoid(g, ctx, {},{}, mode);
+
+    bool tree = false; //whether the search tree of the fastest route is left, not just the route
+    if (g->hasMatrices()) {
+        matrixRoute(g, ctx, origin, dest, mode); //no restrictions yet, so the route is in the matrices
+    } else if (const ContractionHierarchy *ch = ctx.engines->hierarchy; ch != nullptr && ch->isBuilt() && ch->getMode() == mode) {
+        hierarchyDijkstra(g, ctx, *ch, origin, dest); //no restrictions yet, so the hierarchy can be used
+    } else {
+        tree = pointToPoint(g, ctx, origin, dest, mode, ctx.engines->queues.simpleDriving); //perform dijkstra
+    }
 
     //get the path of the fastest route
-    double time = 0;
-    std::vector<int> path1 = getPath(g, origin, dest, time, mode);
+    double time1 = 0;
+    std::vector<int> path1 = getPath(g, ctx, origin, dest, time1, mode);
 
     oss<<"BestDrivingRoute:";
 
@@ -78,33 +711,68 @@ std::string SimpleDriving(Graph * g, const int &origin, const int &dest) {
         return oss.str();
     }
 
-    printPath(path1, oss);
-    oss <<"("<<time<<")\n";
-    oss<<"AlternativeDrivingRoute:";
-
     // Initialize all nodes to perform the Dijkstra algorithm
     // Visited not altered, nodes and edges to be avoided are also not altered
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF, mode);
-        v->setPath(nullptr,mode);
-    }
+    // The layers are swapped so that the search below leaves the tree of the fastest route alone
+    std::swap(ctx.drive, ctx.walk);
+    ctx.resetDist(mode);
 
-    dijkstra(g, origin, dest, mode);
+    pointToPoint(g, ctx, origin, dest, mode, ctx.engines->queues.simpleDriving);
 
-    time = 0;
-    std::vector<int> path2 = getPath(g, origin, dest, time, mode);
+    double time2 = 0;
+    std::vector<int> path2 = getPath(g, ctx, origin, dest, time2, mode);
+    std::swap(ctx.drive, ctx.walk);
+
+    if (path2.empty()) {
+        // The fastest route leaves no alternative, but another route just as fast may leave one
+        const CSRGraph &csr = g->getCSR();
+        std::vector<int> first, second;
+        if (tree) {
+            // Its search gives the potentials of disjointRoutes(...), so only the second pass is left
+            residualRoutes(csr, ctx, g->findVertexIndex(origin), g->findVertexIndex(dest), first, second);
+        } else {
+            initAvoid(g, ctx, {}, {}, mode);
+            disjointRoutes(g, ctx, origin, dest, first, second);
+        }
+        auto toPath = [&](const std::vector<int> &route, double &time) {
+            std::vector<int> ids = {origin};
+            time = 0;
+            for (int e : route) {
+                ids.push_back(csr.id(csr.target(e)));
+                time += csr.drive(e);
+            }
+            return ids;
+        };
+        double firstTime = 0;
+        std::vector<int> firstPath = toPath(first, firstTime);
+        if (!second.empty() && !sameTime(firstTime, time1)) {
+            // The pair with the lowest total is slower, but another fastest route may still leave an alternative
+            if (!tightRoutes(g, ctx, g->findVertexIndex(origin), g->findVertexIndex(dest), first, second)) {
+                second.clear();
+            }
+            firstPath = toPath(first, firstTime);
+        }
+        if (!second.empty() && sameTime(firstTime, time1)) {
+            path1 = std::move(firstPath);
+            path2 = toPath(second, time2);
+        }
+    }
+
+    printPath(path1, oss);
+    oss <<"("<<time1<<")\n";
+    oss<<"AlternativeDrivingRoute:";
 
     if (path2.empty()) {
         oss <<"none\n";
         return oss.str();
     }
     printPath(path2, oss);
-    oss <<"("<<time<<")\n";
+    oss <<"("<<time2<<")\n";
     return oss.str();
 }
 
 // Restricted Route Planning
-std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, const std::unordered_set<int> &avoidNodes,
+std::string RestrictedDriving(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const std::unordered_set<int> &avoidNodes,
     const std::vector<std::pair<int,int>> &avoidEdges,const int &includeNode) {
     int mode = 0; //driving mode
 
@@ -112,22 +780,42 @@ std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, con
     oss << "Source:"<<origin << "\nDestination:" << dest << std::endl;
     oss<<"RestrictedDrivingRoute:";
 
-    initAvoid(g, avoidNodes, avoidEdges, mode);
+    initAvoid(g, ctx, avoidNodes, avoidEdges, mode);
+
+    // With a customizable hierarchy, the restrictions are applied once to its metric and both legs use it;
+    // without restrictions the metric it was built with is used as it is
+    const CustomizableHierarchy *cch = ctx.engines->customizable;
+    if (cch != nullptr && !cch->isBuilt()) cch = nullptr;
+    const HierarchyMetric *metric = nullptr;
+    if (cch != nullptr && ctx.avoidNode.getSetBits().empty() && ctx.avoidEdge.getSetBits().empty()) {
+        metric = &cch->baseMetric();
+    } else if (cch != nullptr) {
+        cch->customize(g->getCSR(), ctx.metric, ctx.avoidNode, ctx.avoidEdge);
+        metric = &ctx.metric;
+    }
+    auto leg = [&](const int &from, const int &to) {
+        if (cch != nullptr) {
+            customizableDijkstra(g, ctx, *cch, *metric, from, to);
+        } else {
+            pointToPoint(g, ctx, from, to, mode, ctx.engines->queues.restrictedDriving);
+        }
+    };
+
     double time = 0;
     std::vector<int> path1;
     if (origin != includeNode) {
-        dijkstra(g, origin, includeNode, mode);
-        path1 = getPath(g, origin, includeNode, time, mode);
+        leg(origin, includeNode);
+        path1 = getPath(g, ctx, origin, includeNode, time, mode);
         if (path1.empty()) {
             oss <<"none\n";
             return oss.str();
         }
         path1.pop_back(); //to not repeat the include node
-        initAgain(g, mode);
+        initAgain(g, ctx, mode);
     }
 
-    dijkstra(g, includeNode, dest, mode);
-    std::vector<int> path2 = getPath(g, includeNode, dest, time, mode);
+    leg(includeNode, dest);
+    std::vector<int> path2 = getPath(g, ctx, includeNode, dest, time, mode);
 
     if (path2.empty()) {
         oss <<"none\n";
@@ -145,9 +833,24 @@ std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, con
 }
 
 
+// Walking dijkstra from the destination of DrivingWalking, unless its tree is cached
+static void walkingTree(const Graph * g, SearchContext &ctx, const int &dest, const double maxWalkTime) {
+    const CSRGraph &csr = g->getCSR();
+    const int t = g->findVertexIndex(dest);
+    const QueueKind queue = ctx.engines->queues.drivingWalking;
+    if (ctx.walkTrees != nullptr && ctx.walkTrees->restore(csr, ctx, t, maxWalkTime, queue)) {
+        return;
+    }
+    dijkstra(g, ctx, dest, -1, WALKING, maxWalkTime, nullptr, queue);
+    if (ctx.walkTrees != nullptr) ctx.walkTrees->store(csr, ctx, t, maxWalkTime, queue);
+}
+
 // Best route for driving and walking
-std::string DrivingWalking(Graph * g, const int &origin, const int &dest, const double maxWalkTime,
-    const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges) {
+std::string DrivingWalking(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const double maxWalkTime,
+    const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges, const int k) {
+    if (k < 1) {
+        throw std::runtime_error("The number of approximate routes must be at least 1");
+    }
     std::ostringstream oss;
     oss << "Source:"<<origin << "\nDestination:" << dest << std::endl;
     int walkMode = 1;
@@ -155,25 +858,45 @@ std::string DrivingWalking(Graph * g, const int &origin, const int &dest, const
 
     // Mark the time needed to walk from parking spots to the destination, but just the ones with
     // the time below the maxWalkingTime allowed
-    initAvoid(g, avoidNodes, avoidEdges, walkMode);
-    dijkstra(g, dest, -1, walkMode, maxWalkTime);
+    initAvoid(g, ctx, avoidNodes, avoidEdges, walkMode);
+    const CSRGraph &csr = g->getCSR();
+    int park_spot = g->findVertexIndex(origin);
+
+    if (g->hasMatrices() && avoidNodes.empty() && avoidEdges.empty()) {
+        // Without restrictions both searches are in the all-pairs matrices, so only the two routes are read
+        park_spot = matrixPark(g, park_spot, g->findVertexIndex(dest), maxWalkTime);
+        matrixRoute(g, ctx, dest, csr.id(park_spot), walkMode);
+        initAgain(g, ctx, driveMode);
+        matrixRoute(g, ctx, origin, csr.id(park_spot), driveMode);
+    } else if (ctx.engines->singlePassParking) {
+        const int park = parkingSearch(g, ctx, origin, dest, maxWalkTime);
+        if (park != -1) park_spot = park;
+    } else {
+        walkingTree(g, ctx, dest, maxWalkTime);
+
+        // Only the parks within walking distance can be chosen; the shortest walks bound the driving search
+        std::vector<int> parks;
+        for (int p : csr.parkingSpots()) {
+            if (!ctx.avoidNode.test(p) && ctx.getDist(p, walkMode) <= maxWalkTime) parks.push_back(p);
+        }
+        std::ranges::sort(parks, {}, [&](int p) { return ctx.getDist(p, walkMode); });
 
-    // Get the better parking spot p
-    initAgain(g, driveMode);
-    Vertex* park_spot = g->findVertex(origin);
-    dijkstra(g, origin, -1,driveMode, maxWalkTime, &park_spot); // checks all vertexes
+        // Get the better parking spot p
+        initAgain(g, ctx, driveMode);
+        dijkstra(g, ctx, origin, -1,driveMode, maxWalkTime, &park_spot, ctx.engines->queues.drivingWalking, &parks);
+    }
 
     // Is the parking spot not viable?
-    if (park_spot->getId()==origin || !park_spot->isPark() || park_spot->getDist(walkMode) > maxWalkTime) {
+    if (csr.id(park_spot)==origin || !csr.isPark(park_spot) || ctx.getDist(park_spot, walkMode) > maxWalkTime) {
         //get approximate solution
-        DrivingWalkingAlternatives(g, origin, dest, oss);
+        DrivingWalkingAlternatives(g, ctx, origin, dest, oss, k);
         return oss.str();
     }
     oss<<"DrivingRoute:";
 
     //get driving route from origin to parking spot
     double time1 = 0;
-    std::vector<int> path1 = getPath(g, origin, park_spot->getId(), time1, driveMode);
+    std::vector<int> path1 = getPath(g, ctx, origin, csr.id(park_spot), time1, driveMode);
     printPath(path1, oss);
     oss<<"("<<time1<<")\n";
     oss<<"ParkingNode:"<<path1.back()<<"\n";
@@ -181,7 +904,7 @@ std::string DrivingWalking(Graph * g, const int &origin, const int &dest, const
 
     //get walking route from parking spot to destination
     double time2 = 0;
-    std::vector<int> path2 = getPath(g, dest, park_spot->getId(), time2, walkMode);
+    std::vector<int> path2 = getPath(g, ctx, dest, csr.id(park_spot), time2, walkMode);
     std::reverse(path2.begin(), path2.end());
     printPath(path2, oss);
     oss<<"("<<time2<<")\n";
@@ -191,87 +914,74 @@ std::string DrivingWalking(Graph * g, const int &origin, const int &dest, const
 
 
 // Approximate Solution
-void DrivingWalkingAlternatives(Graph * g, const int &origin, const int &dest, std::ostringstream &oss) {
+void DrivingWalkingAlternatives(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, std::ostringstream &oss,
+                                const int k) {
+    if (k < 1) {
+        throw std::runtime_error("The number of approximate routes must be at least 1");
+    }
 
     int walkMode = 1;
     int driveMode = 0;
 
     // Perform the dijkstra for walking
-    initAgain(g, walkMode);
-    dijkstra(g, dest, -1, walkMode, INF); // checks all vertexes
-
-    // Perform the Dijkstra for driving
-    initAgain(g,driveMode);
-    Vertex* park_spot = g->findVertex(origin);
-    dijkstra(g, origin, -1,driveMode, INF, &park_spot);
-
-    // Get first driving route from origin to parking spot
-    double time1 = 0;
-    std::vector<int> path1 = getPath(g, origin, park_spot->getId(), time1, 0);
-
-    // Get first walking route from parking spot to destination
-    double time2 = 0;
-    std::vector<int> path2 = getPath(g, dest, park_spot->getId(), time2, 1);
-
-    // No possible parking spots even with no maximum walking time
-    if (park_spot->getId()==origin || path1.empty() || path2.empty()) {
-        oss<<"DrivingRoute:none\n";
-        oss<<"ParkingNode:none\n";
-        oss<<"WalkingRoute:none\n";
-        oss<<"TotalTime:\n";
-        oss << "Message: No possible route because of an absence of reachable parking spots.\n";
-        return;
+    initAgain(g, ctx, walkMode);
+    walkingTree(g, ctx, dest, INF); // checks all vertexes
+
+    // Perform the Dijkstra for driving, ranking the k best parking spots as they are settled
+    initAgain(g, ctx, driveMode);
+    const CSRGraph &csr = g->getCSR();
+    int park_spot = g->findVertexIndex(origin);
+    ParkCandidates candidates(k);
+    dijkstra(g, ctx, origin, -1,driveMode, INF, &park_spot, ctx.engines->queues.drivingWalking, nullptr, &candidates);
+
+    // The best parking spot is the one of the search, the others follow in their ranking (k kept, in case it is one)
+    std::vector<int> parks = {park_spot};
+    for (int v : candidates.ranked()) {
+        if (v != park_spot && static_cast<int>(parks.size()) < k) parks.push_back(v);
     }
 
-    oss<<"DrivingRoute1:";
-    printPath(path1, oss);
-    oss<<"("<<time1<<")\n";
-    oss<<"ParkingNode1:"<<path1.back()<<"\n";
-    oss<<"WalkingRoute1:";
-
-    std::reverse(path2.begin(), path2.end());
-    printPath(path2, oss);
-    oss<<"("<<time2<<")\n";
-    oss<<"TotalTime1:"<<time1+time2<<"\n";
-
-    // Get the parking spot to the second alternative
-    Vertex *secondPark = g->findVertex(origin);
-    for (auto v : g->getVertexSet()) {
-        if (v->isAvoiding())continue;
-        if (v->isPark() && v->getId() != park_spot->getId()) {
-            secondPark = betterPark(secondPark, v, INF) ? secondPark : v;
+    for (int i = 1; i <= k; i++) {
+        const int park = i <= static_cast<int>(parks.size()) ? parks[i - 1] : -1;
+
+        // Get driving route from origin to parking spot
+        double time1 = 0;
+        std::vector<int> path1;
+        if (park != -1) path1 = getPath(g, ctx, origin, csr.id(park), time1, 0);
+
+        // Get walking route from parking spot to destination
+        double time2 = 0;
+        std::vector<int> path2;
+        if (park != -1) path2 = getPath(g, ctx, dest, csr.id(park), time2, 1);
+
+        // No possible parking spots even with no maximum walking time
+        if (park == -1 || csr.id(park)==origin || path1.empty() || path2.empty()) {
+            oss<<"DrivingRoute:none\n";
+            oss<<"ParkingNode:none\n";
+            oss<<"WalkingRoute:none\n";
+            oss<<"TotalTime:\n";
+            if (i == 1) {
+                oss << "Message: No possible route because of an absence of reachable parking spots.\n";
+            } else {
+                oss << "Message: No possible approximate route" << i << " because of an absence of another reachable parking spot.\n";
+            }
+            return;
         }
-    }
-
-    // Get second driving route from origin to parking spot
-    time1 = 0;
-    path1 = getPath(g, origin, secondPark->getId(), time1, 0);
-
-    // Get walking route from parking spot to destination
-    time2 = 0;
-    path2 = getPath(g, dest, secondPark->getId(), time2, 1);
 
-    // No possible parking spots even with no maximum walking time
-    if (secondPark->getId()==origin || path1.empty() || path2.empty()) {
-        oss<<"DrivingRoute:none\n";
-        oss<<"ParkingNode:none\n";
-        oss<<"WalkingRoute:none\n";
-        oss<<"TotalTime:\n";
-        oss << "Message: No possible approximate route2 because of an absence of another reachable parking spot.\n";
-        return;
+        oss<<"DrivingRoute"<<i<<":";
+        printPath(path1, oss);
+        oss<<"("<<time1<<")\n";
+        oss<<"ParkingNode"<<i<<":"<<path1.back()<<"\n";
+        oss<<"WalkingRoute"<<i<<":";
+
+        std::reverse(path2.begin(), path2.end());
+        printPath(path2, oss);
+        oss<<"("<<time2<<")\n";
+        oss<<"TotalTime"<<i<<":"<<time1+time2<<"\n";
     }
-    oss<<"DrivingRoute2:";
-    printPath(path1, oss);
-    oss<<"("<<time1<<")\n";
-    oss<<"ParkingNode2:"<<path1.back()<<"\n";
-    oss<<"WalkingRoute2:";
-
-    std::reverse(path2.begin(), path2.end());
-    printPath(path2, oss);
-    oss<<"("<<time2<<")\n";
-    oss<<"TotalTime2:"<<time1+time2<<"\n";
 
+    static const char *const counts[] = {"one", "two", "three", "four", "five"};
     oss << "Message:No possible route with the max walking time proposed. Nevertheless, it is possible to offer \n"
-           "two approximate routes where the maximum walking time is not the one initially desired, but all other\n"
-            "parameters were followed.\n";
+        << (k <= 5 ? counts[k - 1] : std::to_string(k).c_str()) << " approximate route" << (k == 1 ? "" : "s")
+        << " where the maximum walking time is not the one initially desired, but all other\n"
+           "parameters were followed.\n";
 }
\ No newline at end of file
@@ -3,8 +3,17 @@
 
 #include <algorithm>
 #include <sstream>
+#include <type_traits>
 
 #include "../data_structures/Graph.h"
+#include "../data_structures/IndexedPriorityQueue.h"
+#include "../data_structures/DaryHeap.h"
+#include "../data_structures/RadixHeap.h"
+#include "../data_structures/BucketQueue.h"
+#include "../data_structures/LandmarkTable.h"
+#include "../data_structures/ContractionHierarchy.h"
+#include "../data_structures/CustomizableHierarchy.h"
+#include "../data_structures/ParkCandidates.h"
 #include "util.h"
 
 /**
@@ -15,19 +24,175 @@
  *  returns the best node to park the car to continue the rest of the route on foot.
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path wanted.
  * @param dest The id of the destination vertex of the path wanted.
  * @param mode Int of the mode of transportation, 0->driving, 1->walking.
  * @param maxWalkTime Double with maximum time allowed to be walking by the algorithm. (not mandatory)
- * @param u Pointer to a pointer of a vertex of the better parking spot for the requested route, default value nullptr,
- * when the function is called, the vertex is the origin.
+ * @param u Pointer to the dense index of the better parking spot for the requested route, default value nullptr,
+ * when the function is called, the index is the one of the origin.
+ * @param parks If set (with u), the parking spots that can be chosen, that is those within maxWalkTime of the
+ * destination in the walking layer, sorted by walking time. The search then stops as soon as none of the parks it
+ * has not settled can replace *u, instead of settling every reachable vertex.
+ * @param candidates If set (with u), every parking spot settled that can be reached on foot in the walking layer is
+ * offered to it, so the k best are ranked during the search.
+ *
+ * @tparam Queue The priority queue: IndexedPriorityQueue, DaryHeap, RadixHeap or BucketQueue. BucketQueue runs
+ * on the integer times of the graph, so it requires CSRGraph::isIntegral().
  *
  * @note Time Complexity: O((V+E)logV) where V and E are the number of vertexes and edges respectively.
  */
-void dijkstra(const Graph * g, const int &origin, const int &dest, int mode, double maxWalkTime = -1, Vertex **u = nullptr);
+template <class Queue>
+void dijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, int mode, double maxWalkTime = -1, int *u = nullptr,
+              const std::vector<int> *parks = nullptr, ParkCandidates *candidates = nullptr);
 
+/**
+ * @brief Runs dijkstra() with the priority queue chosen at run time.
+ *
+ * @param queue The priority queue to use (see QueuePolicy). QueueKind::Bucket is used only if the graph is
+ * integral and falls back to the binary heap otherwise.
+ *
+ * The other parameters are the ones of dijkstra<Queue>().
+ */
+void dijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, int mode, double maxWalkTime = -1,
+              int *u = nullptr, QueueKind queue = QueueKind::Binary, const std::vector<int> *parks = nullptr,
+              ParkCandidates *candidates = nullptr);
 
 
+
+/**
+ * @brief Finds the parking spot of DrivingWalking with a single search over a driving and a walking layer.
+ *
+ * @details The driving layer is a dijkstra from the origin. Every parking spot it settles starts a walk in the
+ * walking layer, over the edges backwards, and the search stops once the destination is settled there. A vertex
+ * keeps every walk that is not both slower and longer than another one, so the answer is the parking spot with the
+ * fastest total whose walk fits in maxWalkTime and, among equal totals, the shortest walk, as in DrivingWalking.
+ * The routes are left in the driving and walking layers.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context with the restrictions of the query (see initAvoid(...)).
+ * @param origin The id of the origin vertex.
+ * @param dest The id of the destination vertex.
+ * @param maxWalkTime The maximum time allowed to walk.
+ * @return The dense index of the parking spot, or -1 if there is none.
+ *
+ * @note Time Complexity: O((V+E+L)log(V+L)) where L is the number of walks kept, usually a few per vertex, and it
+ * stops once the destination is reached.
+ */
+int parkingSearch(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, double maxWalkTime);
+
+/**
+ * @brief Computes the shortest path between two vertices with a bidirectional Dijkstra.
+ *
+ * @details A forward search from the origin and a backward search from the destination (over the incoming edges)
+ * run alternately, and stop once their two smallest keys add up to at least the best path seen between them.
+ * The path is left in the layer of the mode, as dijkstra(...) leaves it.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param origin The id of the origin vertex of the path wanted.
+ * @param dest The id of the destination vertex of the path wanted.
+ * @param mode Int of the mode of transportation, 0->driving, 1->walking.
+ *
+ * @note Time Complexity: O((V+E)logV) where V and E are the number of vertexes and edges respectively, but it
+ * usually settles far fewer vertices than dijkstra(...).
+ */
+void bidirectionalDijkstra(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, int mode);
+
+/**
+ * @brief Computes the shortest path between two vertices with A* and landmark lower bounds (ALT).
+ *
+ * @details The queue is ordered by the distance from the origin plus LandmarkTable::lowerBound(...) to the
+ * destination. Restrictions only make distances longer, so the bounds stay valid with every one of them.
+ * The path is left in the layer of the mode, as dijkstra(...) leaves it.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param landmarks The landmark table of the graph.
+ * @param origin The id of the origin vertex of the path wanted.
+ * @param dest The id of the destination vertex of the path wanted.
+ * @param mode Int of the mode of transportation, 0->driving, 1->walking.
+ *
+ * @note Time Complexity: O(k(V+E)logV) in the worst case, k being the number of landmarks, but it usually
+ * settles a small part of the vertices dijkstra(...) does.
+ */
+void altDijkstra(const Graph * g, SearchContext &ctx, const LandmarkTable &landmarks, const int &origin, const int &dest, int mode);
+
+/**
+ * @brief Reads the fastest route between two vertices from the all-pairs matrices of the graph.
+ *
+ * @details Only valid when no vertex or edge is avoided or visited (see Graph::computeMatrices()). The route is
+ * left in the layer of the mode.
+ *
+ * @param g A pointer to the graph, with its matrices filled.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param origin The id of the origin vertex of the path wanted.
+ * @param dest The id of the destination vertex of the path wanted.
+ * @param mode The mode of travel (0 for driving, 1 for walking).
+ *
+ * @note Time Complexity: O(L), L being the number of edges of the route.
+ */
+void matrixRoute(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, int mode);
+
+/**
+ * @brief Computes the fastest driving route between two vertices with a Contraction Hierarchy.
+ *
+ * @details Only valid when no vertex or edge is avoided or visited, since the hierarchy has no restrictions.
+ * The route, with its shortcuts unpacked, is left in the driving layer.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param hierarchy The Contraction Hierarchy of the graph.
+ * @param origin The id of the origin vertex of the path wanted.
+ * @param dest The id of the destination vertex of the path wanted.
+ *
+ * @note Time Complexity: see ContractionHierarchy::query(...), usually a few hundred vertices and arcs.
+ */
+void hierarchyDijkstra(const Graph * g, SearchContext &ctx, const ContractionHierarchy &hierarchy, const int &origin, const int &dest);
+
+/**
+ * @brief Computes the fastest driving route between two vertices with a Customizable Contraction Hierarchy.
+ *
+ * @details The metric already has the restrictions of the query (see CustomizableHierarchy::customize(...));
+ * visited vertices are ignored. The route is left in the driving layer.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param hierarchy The Customizable Contraction Hierarchy of the graph.
+ * @param metric The metric of the hierarchy to use.
+ * @param origin The id of the origin vertex of the path wanted.
+ * @param dest The id of the destination vertex of the path wanted.
+ *
+ * @note Time Complexity: see CustomizableHierarchy::query(...).
+ */
+void customizableDijkstra(const Graph * g, SearchContext &ctx, const CustomizableHierarchy &hierarchy, const HierarchyMetric &metric,
+                          const int &origin, const int &dest);
+
+/**
+ * @brief Computes the two node-disjoint driving routes with the least total time (Suurballe's algorithm).
+ *
+ * @details Marking the fastest route as visited and searching again, as SimpleDriving does, finds no alternative
+ * when that route cuts every other one, even if two disjoint routes exist. Here the second pass runs in the residual
+ * graph of the fastest route P: its edges can only be taken backwards, which undoes them, and each inner vertex of P
+ * is split in two so that it is still used once. The edge times are reduced by the distances of the first pass
+ * (min(dist, time of P) for the vertices it did not settle), so they stay non-negative and the second pass is a
+ * plain dijkstra. The edges of both routes, less those of P walked backwards, form the two routes.
+ * The routes share no vertex but the origin and the destination and no edge, and the avoided vertices and edges of
+ * ctx are skipped. The distances of the first pass are left in the driving layer, and the walking and back layers
+ * are used by the second one.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context with the restrictions of the query (see initAvoid(...)).
+ * @param origin The id of the origin vertex.
+ * @param dest The id of the destination vertex.
+ * @param first Set to the edge ids of the faster route (empty if there is no route).
+ * @param second Set to the edge ids of the other one (empty if there is no disjoint pair).
+ *
+ * @note Time Complexity: O((V+E)logV), two dijkstras, the second over at most twice the vertices.
+ */
+void disjointRoutes(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, std::vector<int> &first,
+                    std::vector<int> &second);
+
 /**
  * @brief Fastest Route + Independent Route Planning.
  *
@@ -36,8 +201,14 @@ void dijkstra(const Graph * g, const int &origin, const int &dest, int mode, dou
  * and destination, and that the alternative route is equal to or greater in travel time than the primary route.
  * This provides a robust “Plan-B” option for navigation.The routes calculated will be for driving only. The origin
  * and destination can be parking or non-parking nodes.
+ * When the fastest route found leaves no alternative, the pair of disjointRoutes(...) is reported instead if its
+ * faster route is just as fast. When the fastest route was found by dijkstra(...), its search is reused as the first
+ * pass of the pair, so only the second one runs. If the pair is slower, the other fastest routes are tried, and the
+ * first one that leaves an alternative is reported with the fastest route without its vertices. Finding such a route
+ * is NP-hard in general, so this last search gives up after a bounded number of reachability checks.
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path wanted.
  * @param dest The id of the destination vertex of the path wanted.
  *
@@ -45,7 +216,7 @@ void dijkstra(const Graph * g, const int &origin, const int &dest, int mode, dou
  *
  * @note Time Complexity: O((V+E)logV) where V and E are the number of vertexes and edges respectively.
  */
-std::string SimpleDriving(Graph * g, const int &origin, const int &dest);
+std::string SimpleDriving(const Graph * g, SearchContext &ctx, const int &origin, const int &dest);
 
 
 
@@ -61,6 +232,7 @@ std::string SimpleDriving(Graph * g, const int &origin, const int &dest);
  * In the case of the include node, if not applicable, it can be left with the origin node id.
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path wanted.
  * @param dest The id of the destination vertex of the path wanted.
  * @param avoidNodes Unordered set with the ids of the node that are to be avoided.
@@ -70,12 +242,11 @@ std::string SimpleDriving(Graph * g, const int &origin, const int &dest);
  *
  * @return A string where the correct output for the route that was asked.
  *
- * @note Time Complexity: O((V+E)logV + E*N) where V and E are, respectively the number of vertexes and edges
- * of the graph and N is the number of edges to avoid. O((V+E)logV) corresponds to calling the Dijkstra function
- * and O(E*N) to calling avoidNodes(...);
-
+ * @note Time Complexity: O((V+E)logV + N*d) where V and E are, respectively the number of vertexes and edges
+ * of the graph, N is the number of nodes and edges to avoid and d the degree of their end nodes.
+ * O((V+E)logV) corresponds to calling the Dijkstra function and O(N*d) to calling initAvoid(...);
  */
-std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, const std::unordered_set<int> &avoidNodes,
+std::string RestrictedDriving(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const std::unordered_set<int> &avoidNodes,
                               const std::vector<std::pair<int,int>> &avoidEdges,const int &includeNode);
 
 
@@ -86,13 +257,14 @@ std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, con
  * @details This function implements the best (shortest overall) route for driving and walking,
  * ensuring that it drives the first section of the route and then parks the vehicle, walking
  * the remaining distance to the destination. The goal is to minimize both driving and walking time and
- * should there be two or more feasible routes with the same overall minimum travel time, the one with
- * the longest walking section (that obviously meets the maximum walking time restriction) should be
- * selected. The origin and destination cannot be adjacent nor parking nodes.
+ * should there be two or more feasible routes with the same overall minimum travel time, the parking spot the
+ * driving search settles last among them is selected, which is the one with the shortest walking section
+ * (see betterPark(...)). The origin and destination cannot be adjacent nor parking nodes.
  * If no suitable route is found that satisfies all the requirements, it calls the function Driving Walking
  * to give approximate solutions to the problem
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path wanted.
  * @param dest The id of the destination vertex of the path wanted.
  * @param maxWalkTime Double with the maximum time of walking allowed from the park to the
@@ -100,15 +272,20 @@ std::string RestrictedDriving(Graph * g, const int &origin, const int &dest, con
  * @param avoidNodes Unordered set with the ids of the node that are to be avoided.
  * @param avoidEdges Vector of pairs of ints with the ids of the nodes in each side of the
  * edge that should be avoided.
+ * @param k Number of approximate routes offered (at least 1) if no route satisfies the maximum walking time,
+ * see DrivingWalkingAlternatives(...).
  *
  * @return A string where the correct output for the route that was asked.
  *
- * @note Time Complexity: O((V+E)logV + E*N) where V and E are, respectively the number of vertexes and edges
- * of the graph and N is the number of edges to avoid. O((V+E)logV) corresponds to calling the Dijkstra function
- * and O(E*N) to calling avoidNodes(...);
+ * @throws std::runtime_error If k is less than 1.
+ *
+ * @note Time Complexity: O((V+E)logV + N*d) where V and E are, respectively the number of vertexes and edges
+ * of the graph, N is the number of nodes and edges to avoid and d the degree of their end nodes.
+ * O((V+E)logV) corresponds to calling the Dijkstra function and O(N*d) to calling initAvoid(...);
  */
-std::string DrivingWalking(Graph * g, const int &origin, const int &dest, double maxWalkTime,
-                           const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges);
+std::string DrivingWalking(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, double maxWalkTime,
+                           const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges,
+                           int k = 2);
 
 
 
@@ -116,21 +293,28 @@ std::string DrivingWalking(Graph * g, const int &origin, const int &dest, double
  * @brief Approximate Solution
  *
  * @details Called when no suitable route was found using the DrivingWalking(...) that satisfied all the requirements.
- * If possible, it displays (in the output stream oss) 2 suggestions representing the best feasible alternative routes
+ * If possible, it displays (in the output stream oss) k suggestions representing the best feasible alternative routes
  * that do not go along with the maximum walking time required, but follow all other requirements.
  * This function also displays a message with the reason for being called, ex: walking time exceeds predefined maximum
  * limit or absence of reachable parking spots.
+ * The parking spots are ranked by total time while the driving dijkstra settles them (see ParkCandidates), so no
+ * pass over the vertices is needed afterwards, whatever the number of suggestions.
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path wanted.
  * @param dest The id of the destination vertex of the path wanted.
  * @param oss The output stream where the path will be stored in the correct format.
+ * @param k Number of suggestions wanted (at least 1), default 2.
+ *
+ * @throws std::runtime_error If k is less than 1.
  *
- * @note Time Complexity: O((V+E)logV + E*N) where V and E are, respectively the number of vertexes and edges
- * of the graph and N is the number of edges to avoid. O((V+E)logV) corresponds to calling the Dijkstra function
- * and O(E*N) to calling avoidNodes(...);
+ * @note Time Complexity: O((V+E)logV + P*logk + N*d) where V and E are, respectively the number of vertexes and edges
+ * of the graph, P the number of parking spots, N is the number of nodes and edges to avoid and d the degree of their
+ * end nodes. O((V+E)logV) corresponds to calling the Dijkstra function and O(N*d) to calling initAvoid(...);
  */
-void DrivingWalkingAlternatives(Graph * g, const int &origin, const int &dest, std::ostringstream &oss);
+void DrivingWalkingAlternatives(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, std::ostringstream &oss,
+                                int k = 2);
 
 
 #endif //ALGORITHMS_H
@@ -0,0 +1,152 @@
+#include "AlternativeRoutes.h"
+#include "util.h"
+#include "../data_structures/IndexedPriorityQueue.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr double PENALTY_FACTOR = 1.5;  // the time of an edge grows by half each time a route found uses it
+constexpr double MAX_STRETCH = 1.5;     // a route kept takes at most this many times the fastest one
+constexpr int ATTEMPTS_PER_ROUTE = 4;   // searches allowed per route wanted before giving up
+
+}
+
+std::vector<std::vector<int>> alternativeRoutes(const Graph * g, SearchContext &ctx, const int origin, const int dest,
+                                                const int k, const double maxOverlap) {
+    const CSRGraph &csr = g->getCSR();
+    const int s = g->findVertexIndex(origin);
+    const int t = g->findVertexIndex(dest);
+    if (s == -1 || t == -1)
+        throw std::runtime_error("Unknown location id: " + std::to_string(s == -1 ? origin : dest));
+    ctx.fit(csr);
+
+    std::vector<std::vector<int>> routes;
+    auto usable = [&](int w) { return !ctx.avoidNode.test(w) && !ctx.isVisited(w); };
+    if (k < 1 || s == t || !usable(t))
+        return routes;
+
+    // Backward dijkstra from t on the real times: the distance to t and the next edge of the fastest route
+    SearchContext::Layer &bwd = ctx.back;
+    SearchContext::reset(bwd);
+    auto toDest = [&](int v) { return bwd.stamp[v] == bwd.epoch ? bwd.dist[v] : INF; };
+    bwd.dist[t] = 0;
+    bwd.path[t] = -1;
+    bwd.stamp[t] = bwd.epoch;
+    IndexedPriorityQueue qb(bwd.dist, ctx.backQueueIndex);
+    qb.insert(t);
+    while (!qb.empty()) {
+        const int v = qb.extractMin();
+        for (int e : csr.incoming(v)) {
+            if (ctx.avoidEdge.test(e) || csr.drive(e) == -1) continue;
+            const int w = csr.source(e);
+            if (w != s && !usable(w)) continue;
+            const double d = bwd.dist[v] + csr.drive(e);
+            if (d < toDest(w)) {
+                const bool inQueue = toDest(w) != INF;
+                bwd.dist[w] = d;
+                bwd.path[w] = e;
+                bwd.stamp[w] = bwd.epoch;
+                inQueue ? qb.decreaseKey(w) : qb.insert(w);
+            }
+        }
+    }
+    if (toDest(s) == INF)
+        return routes;
+    const double fastest = toDest(s);
+
+    std::vector<int> penalised;     // edges whose penalty is not 1, restored at the end
+    std::unordered_set<int> taken;  // edges of the routes kept
+    auto keep = [&](const std::vector<int> &route) {
+        routes.push_back(route);
+        taken.insert(route.begin(), route.end());
+    };
+    auto penalise = [&](const std::vector<int> &route) {
+        for (int e : route) {
+            if (ctx.penalty[e] == 1) penalised.push_back(e);
+            ctx.penalty[e] *= PENALTY_FACTOR;
+        }
+    };
+
+    std::vector<int> route;
+    for (int v = s; v != t; v = csr.target(bwd.path[v]))
+        route.push_back(bwd.path[v]);
+    keep(route);
+    penalise(route);
+
+    for (int attempt = 0; attempt < ATTEMPTS_PER_ROUTE * k && static_cast<int>(routes.size()) < k; attempt++) {
+        // A* on the penalised times, with the real distances to t as potentials
+        ctx.resetDist(DRIVING);
+        ctx.set<DRIVING>(s, 0, -1);
+        ctx.estimate[s] = fastest;
+        IndexedPriorityQueue q(ctx.estimate, ctx.queueIndex);
+        q.insert(s);
+        while (!q.empty()) {
+            const int v = q.extractMin();
+            if (v == t) break;
+            for (int e : csr.edges(v)) {
+                if (ctx.avoidEdge.test(e) || csr.drive(e) == -1) continue;
+                const int w = csr.target(e);
+                if (!usable(w) || toDest(w) == INF) continue;
+                const double d = ctx.getDist<DRIVING>(v) + csr.drive(e) * ctx.penalty[e];
+                if (d < ctx.getDist<DRIVING>(w)) {
+                    const bool inQueue = ctx.getDist<DRIVING>(w) != INF;
+                    ctx.set<DRIVING>(w, d, e);
+                    ctx.estimate[w] = d + toDest(w);
+                    inQueue ? q.decreaseKey(w) : q.insert(w);
+                }
+            }
+        }
+
+        route.clear();
+        double time = 0, shared = 0;
+        for (int v = t; v != s; v = csr.source(ctx.getPath(v, DRIVING))) {
+            const int e = ctx.getPath(v, DRIVING);
+            route.push_back(e);
+            time += csr.drive(e);
+            if (taken.contains(e)) shared += csr.drive(e);
+        }
+        std::ranges::reverse(route);
+        if (time <= MAX_STRETCH * fastest && shared <= maxOverlap * time) keep(route);
+        penalise(route);
+    }
+
+    for (int e : penalised)
+        ctx.penalty[e] = 1;
+    return routes;
+}
+
+// Driving Alternatives Route Planning
+std::string DrivingAlternatives(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, const int k,
+                                const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges) {
+    std::ostringstream oss;
+    oss << "Source:" << origin << "\nDestination:" << dest << "\n";
+
+    initAvoid(g, ctx, avoidNodes, avoidEdges, DRIVING);
+    const std::vector<std::vector<int>> routes = alternativeRoutes(g, ctx, origin, dest, k);
+
+    if (routes.empty()) {
+        oss << "DrivingRoute1:none\n";
+        return oss.str();
+    }
+
+    const CSRGraph &csr = g->getCSR();
+    for (std::size_t i = 0; i < routes.size(); i++) {
+        std::vector<int> path = {origin};
+        double time = 0;
+        for (int e : routes[i]) {
+            path.push_back(csr.id(csr.target(e)));
+            time += csr.drive(e);
+        }
+        oss << "DrivingRoute" << i + 1 << ":";
+        printPath(path, oss);
+        oss << "(" << time << ")\n";
+    }
+    if (static_cast<int>(routes.size()) < k) {
+        oss << "Message:Only " << routes.size() << " of the " << k << " routes asked for are different enough from "
+               "each other.\n";
+    }
+    return oss.str();
+}
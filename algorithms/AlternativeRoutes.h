@@ -0,0 +1,67 @@
+#ifndef ALTERNATIVEROUTES_H
+#define ALTERNATIVEROUTES_H
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../data_structures/Graph.h"
+#include "../data_structures/SearchContext.h"
+
+/**
+ * @brief Finds up to k driving routes that differ enough from each other, by penalising the routes already found.
+ *
+ * @details The first route is the fastest one. After each search the edges of the route found are made slower
+ * (the times are multiplied by a penalty that grows every time an edge is used again) and the next search runs on
+ * the penalised times, so it is pushed away from the routes already found. A route is kept if at most maxOverlap of
+ * its time is on edges of the routes kept before and it is not much slower than the fastest one; the search gives
+ * up after a few attempts per route.
+ * The fastest times to the destination are computed once, by a backward dijkstra. Penalties only make edges slower,
+ * so they are lower bounds for every penalised search, which runs as A* with them as potentials: each attempt only
+ * resets the epoch of the driving layer and settles little more than the vertices near its route.
+ * The avoided and visited vertices and the avoided edges of ctx are skipped, as in dijkstra(...). The driving and
+ * back layers are overwritten.
+ *
+ * @param g A pointer to the graph.
+ * @param ctx The search context with the restrictions of the query (see initAvoid(...)).
+ * @param origin The id of the origin vertex.
+ * @param dest The id of the destination vertex.
+ * @param k The number of routes wanted.
+ * @param maxOverlap The largest part (0 to 1) of the time of a route that may be shared with the routes before it.
+ * @return The routes found as edge ids, the fastest first, then in the order they were found (at most k, none if
+ * the destination cannot be reached).
+ *
+ * @throws std::runtime_error if an id is not a location of the graph.
+ *
+ * @note Time Complexity: O((V+E)logV) for the backward dijkstra plus O(k) A* searches, each one O((V+E)logV) in the
+ * worst case but usually much smaller.
+ */
+std::vector<std::vector<int>> alternativeRoutes(const Graph * g, SearchContext &ctx, int origin, int dest, int k,
+                                                double maxOverlap = 0.5);
+
+/**
+ * @brief Driving Alternatives Route Planning.
+ *
+ * @details Lists up to k driving routes between a source and a destination that are meaningfully different from
+ * each other (see alternativeRoutes(...)), the fastest first, avoiding the given nodes and segments. If fewer than k
+ * routes differ enough, a message says so.
+ *
+ * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
+ * @param origin The id of the origin vertex of the routes wanted.
+ * @param dest The id of the destination vertex of the routes wanted.
+ * @param k The number of routes wanted (at least 1).
+ * @param avoidNodes Unordered set with the ids of the node that are to be avoided.
+ * @param avoidEdges Vector of pairs of ints with the ids of the nodes in each side of the
+ * edge that should be avoided.
+ *
+ * @return A string with the output of the routes asked for.
+ *
+ * @note Time Complexity: see alternativeRoutes(...), plus O(N*d) to call initAvoid(...), N being the number of nodes
+ * and edges to avoid and d the degree of their end nodes.
+ */
+std::string DrivingAlternatives(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, int k,
+                                const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges);
+
+#endif //ALTERNATIVEROUTES_H
@@ -0,0 +1,96 @@
+#include "DistanceTable.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+void DistanceTable::writeCsv(std::ostream &out) const {
+    out << "Source";
+    for (int t : targets)
+        out << ',' << t;
+    out << '\n';
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        out << sources[i];
+        for (std::size_t j = 0; j < targets.size(); j++) {
+            const double time = at(static_cast<int>(i), static_cast<int>(j));
+            out << ',';
+            if (time == INF) out << 'X';
+            else out << time;
+        }
+        out << '\n';
+    }
+}
+
+void DistanceTable::writeCsv(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out)
+        throw std::runtime_error("Failed to open table file: " + path);
+    writeCsv(out);
+    if (!out)
+        throw std::runtime_error("Failed to write table file: " + path);
+}
+
+// Dense indices of a list of ids
+static std::vector<int> indicesOf(const Graph * g, const std::vector<int> &ids) {
+    std::vector<int> res;
+    res.reserve(ids.size());
+    for (int id : ids) {
+        const int v = g->findVertexIndex(id);
+        if (v == -1)
+            throw std::runtime_error("Unknown location id: " + std::to_string(id));
+        res.push_back(v);
+    }
+    return res;
+}
+
+DistanceTable computeTable(const Graph * g, SearchContext &ctx, const ContractionHierarchy &hierarchy,
+                           const std::vector<int> &sources, const std::vector<int> &targets) {
+    if (!hierarchy.isBuilt())
+        throw std::runtime_error("The contraction hierarchy was not built");
+    const CSRGraph &csr = g->getCSR();
+    ctx.fit(csr);
+    const std::vector<int> s = indicesOf(g, sources), t = indicesOf(g, targets);
+    const int n = csr.numVertices();
+
+    DistanceTable table;
+    table.mode = hierarchy.getMode();
+    table.sources = sources;
+    table.targets = targets;
+    table.times.assign(s.size() * t.size(), INF);
+
+    // 1. Backward search from every destination, then its entries grouped by vertex (counting sort), so a
+    // forward search reads the bucket of a vertex contiguously
+    struct Entry {
+        int target;   // column of the destination
+        double dist;  // distance from the vertex to it
+    };
+    std::vector<std::pair<int, double>> space;
+    std::vector<std::pair<int, Entry>> entries;
+    std::vector<int> offsets(n + 1, 0);
+    for (int j = 0; j < static_cast<int>(t.size()); j++) {
+        hierarchy.upwardSearch(ctx, t[j], false, space);
+        for (auto [v, d] : space) {
+            entries.push_back({v, {j, d}});
+            offsets[v + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++)
+        offsets[v + 1] += offsets[v];
+    std::vector<Entry> buckets(entries.size());
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (const auto &[v, entry] : entries)
+        buckets[next[v]++] = entry;
+
+    // 2. Forward search from every origin, scanning the buckets of the vertices it settles
+    for (int i = 0; i < static_cast<int>(s.size()); i++) {
+        double *row = table.times.data() + static_cast<std::size_t>(i) * t.size();
+        hierarchy.upwardSearch(ctx, s[i], true, space);
+        for (auto [v, d] : space) {
+            for (int b = offsets[v]; b < offsets[v + 1]; b++) {
+                const double time = d + buckets[b].dist;
+                if (time < row[buckets[b].target]) row[buckets[b].target] = time;
+            }
+        }
+    }
+    return table;
+}
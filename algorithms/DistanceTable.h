@@ -0,0 +1,74 @@
+#ifndef DISTANCETABLE_H
+#define DISTANCETABLE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../data_structures/Graph.h"
+#include "../data_structures/SearchContext.h"
+#include "../data_structures/ContractionHierarchy.h"
+
+/**
+ * @brief Travel times between every origin and every destination of a batch.
+ */
+struct DistanceTable {
+    int mode = 0;               ///< Mode of travel of the times (0 for driving, 1 for walking).
+    std::vector<int> sources;   ///< Ids of the origins, one per row.
+    std::vector<int> targets;   ///< Ids of the destinations, one per column.
+    std::vector<double> times;  ///< Row-major times, INF where there is no route.
+
+    /**
+     * @brief Gets the time from an origin to a destination.
+     *
+     * @param i The row of the origin.
+     * @param j The column of the destination.
+     * @return The time of the fastest route, INF if there is none.
+     */
+    double at(int i, int j) const { return times[static_cast<std::size_t>(i) * targets.size() + j]; }
+
+    /**
+     * @brief Writes the table as CSV: a header with the destination ids, then one row per origin.
+     *
+     * @details Missing routes are written as X, as in the distances file.
+     *
+     * @param out The stream where the table is written.
+     *
+     * @note Time Complexity: O(S*T).
+     */
+    void writeCsv(std::ostream &out) const;
+
+    /**
+     * @brief Writes the table as CSV to a file.
+     *
+     * @param path The path of the file, which is overwritten.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeCsv(const std::string &path) const;
+};
+
+/**
+ * @brief Computes the fastest travel times from every origin to every destination with a Contraction Hierarchy.
+ *
+ * @details A backward upward search from each destination leaves a bucket entry (destination, distance) at every
+ * vertex it settles. A forward upward search from each origin then scans the buckets of the vertices it settles:
+ * the time to a destination is the smallest forward distance plus bucket distance. So S+T small searches replace
+ * the S*T point-to-point queries. Restrictions are not taken into account, since the hierarchy has none.
+ *
+ * @param g A pointer to the graph.
+ * @param ctx The search context; its driving and backward layers are overwritten.
+ * @param hierarchy The Contraction Hierarchy of the graph, built for the mode wanted.
+ * @param sources The ids of the origins.
+ * @param targets The ids of the destinations.
+ * @return The table of times, in the mode of the hierarchy.
+ *
+ * @throws std::runtime_error if an id is not a location of the graph or the hierarchy was not built.
+ *
+ * @note Time Complexity: O((S+T)*(V'+E')logV' + S*B), V' and E' being the size of a search space in the
+ * hierarchy and B the bucket entries scanned by a forward search.
+ */
+DistanceTable computeTable(const Graph * g, SearchContext &ctx, const ContractionHierarchy &hierarchy,
+                           const std::vector<int> &sources, const std::vector<int> &targets);
+
+#endif //DISTANCETABLE_H
@@ -14,89 +14,88 @@ void printPath(const std::vector<int> &v, std::ostringstream &oss) {
 }
 
 
-std::vector<int> getPath(Graph * g, const int &origin, const int &dest, double &time, const int mode) {
+std::vector<int> getPath(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, double &time, const int mode) {
+    const CSRGraph &csr = g->getCSR();
     std::vector<int> res;
-    Vertex *v = g->findVertex(dest);
+    int v = g->findVertexIndex(dest);
 
-    time += v->getDist(mode);
+    time += ctx.getDist(v, mode);
 
-    while (v->getId() != origin) {
+    while (csr.id(v) != origin) {
 
         //marks the route as visited in case it is supposed to get the alternative route later
-        if (v->getId() != dest) {
-            v->setVisited(true);
+        if (csr.id(v) != dest) {
+            ctx.setVisited(v);
         }
 
-        res.push_back(v->getId());
-        if ( v->getPath(mode) == nullptr) {
+        res.push_back(csr.id(v));
+        if (ctx.getPath(v, mode) == -1) {
             time=-1;
             return {};
         }
 
-        v = v->getPath(mode)->getOrig();
+        v = csr.source(ctx.getPath(v, mode));
 
     }
-    res.push_back(v->getId());
+    res.push_back(csr.id(v));
     std::reverse(res.begin(), res.end());
     return res;
 }
 
 
-void initAvoid(Graph * g,  const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges, int mode) {
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF, mode);
-        v->setPath(nullptr, mode);
-        v->setVisited(false);
-        v->setAvoiding(avoidNodes.contains(v->getId()));
-
-        for (auto e: v->getAdj()) {
-            e->setAvoiding(false);
-            for (auto j : avoidEdges) {
-                if ((e->getOrig()->getId() == j.first && e->getDest()->getId() == j.second)
-                    || (e->getOrig()->getId() == j.second && e->getDest()->getId() == j.first)) {
-                    e->setAvoiding(true);
-                    }
-            }
-        }
-    }
-}
+void initAvoid(const Graph * g, SearchContext &ctx, const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges, int mode) {
+    const CSRGraph &csr = g->getCSR();
+    ctx.fit(csr);
+    ctx.resetDist(mode);
+    ctx.resetVisited();
 
+    // Only the restrictions of the previous query are cleared
+    ctx.avoidNode.clear();
+    ctx.avoidEdge.clear();
+
+    for (int id : avoidNodes) {
+        int v = g->findVertexIndex(id);
+        if (v != -1) ctx.avoidNode.set(v);
+    }
 
-void initAgain(Graph * g, int mode) {
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF, mode);
-        v->setPath(nullptr, mode);
-        v->setVisited(false);
+    // A segment is avoided in both directions, and so are parallel edges between the same nodes
+    for (auto j : avoidEdges) {
+        int a = g->findVertexIndex(j.first);
+        int b = g->findVertexIndex(j.second);
+        if (a == -1 || b == -1) continue;
+        for (int e : csr.edges(a))
+            if (csr.target(e) == b) ctx.avoidEdge.set(e);
+        for (int e : csr.edges(b))
+            if (csr.target(e) == a) ctx.avoidEdge.set(e);
     }
 }
 
 
-bool relax(Edge *edge, const int mode) { // d[u] + w(u,v) < d[v]
-    Vertex *u = edge->getOrig();
-    Vertex *v = edge->getDest();
-    if (v->getDist(mode) > u->getDist(mode) + edge->getTime(mode)) {
-        v->setDist(u->getDist(mode) + edge->getTime(mode), mode);
-        v->setPath(edge, mode);
-        return true;
-    }
-    return false;
+void initAgain(const Graph * g, SearchContext &ctx, int mode) {
+    ctx.fit(g->getCSR());
+    ctx.resetDist(mode);
+    ctx.resetVisited();
 }
 
 
-bool betterPark(Vertex *u, Vertex *v, double maxWalkTime) { //is u a better parking spot thant v?
-    if (v->getDist(1) > maxWalkTime) {  // v is not a valid parking spot because it exceeds max walking time
+bool betterPark(const CSRGraph &csr, const SearchContext &ctx, const int u, const int v, double maxWalkTime) { //is u a better parking spot thant v?
+    return betterPark(csr.isPark(u), ctx.getDist(u, 0), ctx.getDist(u, 1), ctx.getDist(v, 0), ctx.getDist(v, 1), maxWalkTime);
+}
+
+bool betterPark(const bool parkU, const double driveU, const double walkU, const double driveV, const double walkV, double maxWalkTime) {
+    if (walkV > maxWalkTime) {  // v is not a valid parking spot because it exceeds max walking time
         return true;
     }
-    if (!u->isPark()) {// Vertex u exceeds max time but v doesnt
+    if (!parkU) {// Vertex u exceeds max time but v doesnt
         return false;
     }
 
-    if (u->getDist(0) + u->getDist(1) == v->getDist(0) + v->getDist(1)) {// if both have the same time
-        return u->getDist(1) > v->getDist(0) + v->getDist(1); //the one that walks more is the better choice
+    if (driveU + walkU == driveV + walkV) {// if both have the same time
+        return false; //v, the one compared later, wins: the searches settle it later, so it walks less
     }
 
     // the one that that takes the least time is better
-    return (u->getDist(0) + u->getDist(1) < v->getDist(0) + v->getDist(1));
+    return (driveU + walkU < driveV + walkV);
 }
 
 
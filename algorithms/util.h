@@ -6,6 +6,7 @@
 #include <sstream>
 
 #include "../data_structures/Graph.h"
+#include "../data_structures/SearchContext.h"
 
 
 /**
@@ -23,6 +24,7 @@ void printPath(const std::vector<int> &v, std::ostringstream &oss);
  * @brief Get path previously calculated from origin to dest and mark all nodes as visited.
  *
  * @param g A pointer to the graph that has the origin and destination Vertex.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param origin The id of the origin vertex of the path that is being calculated.
  * @param dest The id of the destination vertex of the path that is being calculated.
  * @param time A reference to a double where the total time of the path is being held.
@@ -32,56 +34,101 @@ void printPath(const std::vector<int> &v, std::ostringstream &oss);
  *
  * @note Time Complexity: O(n) where n is the size of the return vector.
  */
-std::vector<int> getPath(Graph * g, const int &origin, const int &dest, double &time, int mode);
+std::vector<int> getPath(const Graph * g, SearchContext &ctx, const int &origin, const int &dest, double &time, int mode);
 
 /**
  * @brief Initializes all vertex to perform the Dijkstra Algorithm.
  * Checks if any vertex or edge should be avoided.
  *
- * @details Resets distance, walkDistance, path and walkPath. Mark all vertex as not visited.
- * Set vertexes and edges to avoid if needed, otherwise to not avoid.
+ * @details Resets the distance and path of the given mode and marks all vertex as not visited,
+ * both in O(1) by starting a new epoch in the context.
+ * Set vertexes and edges to avoid if needed, otherwise to not avoid. Avoided segments are resolved to
+ * edge ids through the vertex index, in both directions.
  *
  * @param g A pointer to the graph that is being worked on.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  * @param avoidNodes Unordered set with the ids of the node that are to be avoided.
  * @param avoidEdges Vector of pairs of ints with the ids of the nodes in each side of the
  * edge that should be avoided.
  *
- * @note Time Complexity: O(V + E * N) where, V is the number of vertex in the graph,
- * E is the number of edges and N is the number of edges to avoid.
+ * @note Time Complexity: O(N * d + K) where N is the number of nodes and edges to avoid, d is the degree
+ * of their end nodes and K is the number of restrictions applied by the previous query (the only ones cleared).
  */
-void initAvoid(Graph * g,  const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges, int mode);
+void initAvoid(const Graph * g, SearchContext &ctx, const std::unordered_set<int> &avoidNodes, const std::vector<std::pair<int,int>> &avoidEdges, int mode);
 
 /**
  * @brief Initializes the graph for the Dijkstra algorithm.
  *
- * @details Set distance, path and visited, to perform the Dijkstra Algorithm.
+ * @details Set distance, path and visited, to perform the Dijkstra Algorithm. Only the epochs of the
+ * context are advanced, no vertex is touched.
  * This is usually the second time the graph is being initialized for the same input,
  * so the edges and vertexes to be avoided haven't changed. As such they do not need to
  * be altered.
  *
  * @param g A pointer to the graph that is being worked on.
+ * @param ctx The search context that holds the state of this query (distances, paths and flags).
  *
- * @note Time Complexity: O(V) where V is the number of vertexes in the graph.
+ * @note Time Complexity: O(1).
  */
-void initAgain(Graph * g, int mode);
+void initAgain(const Graph * g, SearchContext &ctx, int mode);
 
 /**
  * @brief  See if using this edge is a better way to reach vertex v. Set the predecessor
  * of v to u if it is better to use edge e from u to v (edge relaxation).
  *
  * @details Called when doing the Dijkstra Algorithm. Differs a little from the original,
- * as an int variable called mode is passed representing if the person is walking or driving. That way, when we
- * want the distance of the edge (time in this case) it is possible to call a method that
- * gives the time according to the mode of transportation.
+ * as the mode (driving or walking) is a template argument. That way, when we want the distance
+ * of the edge (time in this case), the time of that mode is read directly, with no branch on the mode.
+ * Defined here so that it is inlined into the search loop.
  *
- * @param edge Pointer to the edge to be relaxed.
- * @param mode Int of the mode of transportation, 0->driving, 1->walking.
+ * @tparam Mode DRIVING or WALKING.
+ * @param csr The CSR representation of the graph.
+ * @param ctx The search state where the distances and paths are stored.
+ * @param e Id of the edge to be relaxed.
+ *
+ * @return boolean that is true if edge was relaxed, false otherwise.
+ *
+ * @note Time Complexity: O(1).
+ */
+template <int Mode>
+bool relax(const CSRGraph &csr, SearchContext &ctx, const int e) { // d[u] + w(u,v) < d[v]
+    const int u = csr.source(e);
+    const int v = csr.target(e);
+    const double d = ctx.getDist<Mode>(u) + csr.time<Mode>(e);
+    if (ctx.getDist<Mode>(v) > d) {
+        ctx.set<Mode>(v, d, e);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Edge relaxation over the integer times of the graph (see CSRGraph::isIntegral()).
+ *
+ * @details Same as relax(...), but the distances are added and compared as 32-bit integers (the double
+ * distance is kept up to date too).
+ *
+ * @tparam Mode DRIVING or WALKING.
+ * @param csr The CSR representation of the graph, which must be integral.
+ * @param ctx The search state where the distances and paths are stored.
+ * @param e Id of the edge to be relaxed.
  *
  * @return boolean that is true if edge was relaxed, false otherwise.
  *
  * @note Time Complexity: O(1).
  */
-bool relax(Edge *edge, int mode);
+template <int Mode>
+bool relaxMinutes(const CSRGraph &csr, SearchContext &ctx, const int e) {
+    const SearchContext::Layer &l = ctx.layer<Mode>();
+    const int u = csr.source(e);
+    const int v = csr.target(e);
+    const int32_t d = l.minutes[u] + csr.minutes<Mode>(e);
+    if (l.stamp[v] != l.epoch || d < l.minutes[v]) {
+        ctx.setMinutes<Mode>(v, d, e);
+        return true;
+    }
+    return false;
+}
 
 /**
  * @brief Compares two vertexes and chooses the one that is a better option to park on.
@@ -95,16 +142,35 @@ bool relax(Edge *edge, int mode);
  * Now that only leaves us on the cases where both vertexes are valid parking spots.
  * The one that takes less time overall (driveDist (driving time from origin to that node) + walkDist(walking
  * time from that node to the destination)) is the better parking spot. Should they have the same overall
- * minimum travel time, the one with the longest walkTime is the better option.
+ * minimum travel time, v (the one compared later) is the better option: the searches compare the parks in the
+ * order they are settled, so on a tie the one that drives more, and walks less, wins.
+ *
+ * @param csr The CSR representation of the graph.
+ * @param ctx The search state holding the driving and walking distances.
+ * @param u Dense index of vertex u
+ * @param v Dense index of vertex v
+ * @param maxWalkTime double with maximum time allowed to be walking by the algorithm
+ *
+ * @return boolean that returns true if v is an invalid parking spot of if u is the better choice. False otherwise
+ *
+ * @note Time Complexity: O(1).
+ */
+bool betterPark(const CSRGraph &csr, const SearchContext &ctx, int u, int v, double maxWalkTime);
+
+/**
+ * @brief Same comparison as betterPark(csr, ctx, u, v, maxWalkTime), on given driving and walking times.
  *
- * @param u pointer to vertex u
- * @param v pointer to vertex v
+ * @param parkU Whether u is a parking spot.
+ * @param driveU Driving time from the origin to u.
+ * @param walkU Walking time from u to the destination.
+ * @param driveV Driving time from the origin to v.
+ * @param walkV Walking time from v to the destination.
  * @param maxWalkTime double with maximum time allowed to be walking by the algorithm
  *
  * @return boolean that returns true if v is an invalid parking spot of if u is the better choice. False otherwise
  *
  * @note Time Complexity: O(1).
  */
-bool betterPark(Vertex *u, Vertex *v, double maxWalkTime);
+bool betterPark(bool parkU, double driveU, double walkU, double driveV, double walkV, double maxWalkTime);
 
 #endif //UTIL_H
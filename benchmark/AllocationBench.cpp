@@ -0,0 +1,59 @@
+// Micro-benchmark: heap allocations performed while iterating the graph and answering queries.
+// Usage: DAProject1Bench [locations.csv distances.csv]   (run from the build directory)
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "../algorithms/Algorithms.h"
+
+static long allocations = 0;
+
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char **argv) {
+    std::string locs = argc > 2 ? argv[1] : "../data/Locations.csv";
+    std::string dists = argc > 2 ? argv[2] : "../data/Distances.csv";
+    Graph g = initialize(locs, dists);
+    SearchContext ctx;
+
+    // Visit every edge once, as a Dijkstra over the full graph does.
+    long edges = 0;
+    long before = allocations;
+    for (auto v : g.getVertexSet()) {
+        for (auto e : v->getAdj()) edges += e->getDest() != nullptr;
+    }
+    long viewAllocs = allocations - before;
+
+    // Same traversal with the by-value copies the old getVertexSet()/getAdj() made.
+    before = allocations;
+    std::vector<Vertex *> vertices(g.getVertexSet().begin(), g.getVertexSet().end());
+    for (auto v : vertices) {
+        std::vector<Edge *> adj(v->getAdj().begin(), v->getAdj().end());
+        for (auto e : adj) edges += e->getDest() != nullptr;
+    }
+    long copyAllocs = allocations - before;
+
+    // Whole queries, first one excluded (it sizes the context).
+    const auto vs = g.getVertexSet();
+    const int origin = vs.front()->getId(), dest = vs.back()->getId();
+    SimpleDriving(&g, ctx, origin, dest);
+    const int runs = 100;
+    before = allocations;
+    for (int i = 0; i < runs; i++) SimpleDriving(&g, ctx, origin, dest);
+    long queryAllocs = allocations - before;
+
+    std::cout << "vertices: " << vs.size() << ", edges visited: " << edges / 2 << "\n";
+    std::cout << "full traversal, span views:       " << viewAllocs << " allocations\n";
+    std::cout << "full traversal, by-value vectors: " << copyAllocs << " allocations\n";
+    std::cout << "SimpleDriving query (average):    " << queryAllocs / runs << " allocations\n";
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef AVOIDMASK_H
+#define AVOIDMASK_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Bitset over vertex indices or edge ids that remembers which bits are set.
+ *
+ * @details Used for the avoidNodes/avoidEdges restrictions: clearing only touches the bits set by the
+ * previous query, so applying a new set of restrictions costs O(number of restrictions) instead of
+ * O(V + E).
+ */
+class AvoidMask {
+public:
+    /**
+     * @brief Sizes the mask and clears every bit.
+     *
+     * @param n Number of elements.
+     */
+    void resize(int n) {
+        words.assign((n + 63) / 64, 0);
+        size = n;
+        setBits.clear();
+    }
+
+    /**
+     * @brief Gets the number of elements the mask was sized for.
+     *
+     * @return The number of elements.
+     */
+    int getSize() const { return size; }
+
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    void set(int i) {
+        if (!test(i)) {
+            words[i >> 6] |= uint64_t(1) << (i & 63);
+            setBits.push_back(i);
+        }
+    }
+
+    /**
+     * @brief Clears every set bit.
+     *
+     * @note Time Complexity: O(k) where k is the number of bits currently set.
+     */
+    void clear() {
+        for (int i : setBits) words[i >> 6] = 0;
+        setBits.clear();
+    }
+
+    /**
+     * @brief Gets the bits currently set, in the order they were set.
+     *
+     * @return Reference to the list of set indices.
+     */
+    const std::vector<int> &getSetBits() const { return setBits; }
+
+private:
+    std::vector<uint64_t> words;  ///< Bit storage.
+    std::vector<int> setBits;     ///< Indices of the bits currently set.
+    int size = 0;                 ///< Number of elements.
+};
+
+#endif //AVOIDMASK_H
@@ -0,0 +1,65 @@
+/*
+ * BucketQueue.h
+ * Dial's bucket queue over dense vertex indices, keyed by an external array of integer distances.
+ * It only works when the first key inserted is 0, no key smaller than the last extracted one is ever inserted and every key in the queue is
+ * at most maxWeight above it, which is always the case in Dijkstra's algorithm with edge weights <= maxWeight.
+ */
+
+#ifndef DA_TP_CLASSES_BUCKETQUEUE
+#define DA_TP_CLASSES_BUCKETQUEUE
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * The maxWeight + 1 buckets are used circularly: bucket k % (maxWeight + 1) holds the indices with key k, so
+ * insert, decreaseKey and extractMin take O(1) amortized time.
+ * decreaseKey inserts a new entry instead of moving the old one; an entry is stale (and dropped) once its key
+ * no longer matches key[x].
+ */
+class BucketQueue {
+    using Entry = std::pair<int32_t, int>; // (key, index)
+    std::vector<std::vector<Entry>> buckets;
+    const std::vector<int32_t> &key;
+    int32_t current = 0; // key of the bucket being emptied
+    int live = 0;        // number of indices in the queue (stale entries not counted)
+    void push(int x) { buckets[key[x] % buckets.size()].emplace_back(key[x], x); }
+
+public:
+    BucketQueue(const std::vector<int32_t> &key, int32_t maxWeight);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    bool empty() const { return live == 0; }
+};
+
+inline BucketQueue::BucketQueue(const std::vector<int32_t> &key, int32_t maxWeight)
+    : buckets(static_cast<std::size_t>(maxWeight) + 1), key(key) { }
+
+inline int BucketQueue::extractMin() {
+    while (true) {
+        std::vector<Entry> &b = buckets[current % buckets.size()];
+        if (b.empty()) {
+            current++;
+            continue;
+        }
+        Entry e = b.back();
+        b.pop_back();
+        if (e.first != key[e.second])
+            continue;
+        live--;
+        return e.second;
+    }
+}
+
+inline void BucketQueue::insert(int x) {
+    push(x);
+    live++;
+}
+
+inline void BucketQueue::decreaseKey(int x) {
+    push(x);
+}
+
+#endif /* DA_TP_CLASSES_BUCKETQUEUE */
@@ -0,0 +1,114 @@
+#include "CSRGraph.h"
+#include "Graph.h"
+
+#include <algorithm>
+#include <atomic>
+
+std::uint64_t CSRGraph::nextVersion() {
+    static std::atomic<std::uint64_t> versions{0};
+    return ++versions;
+}
+
+void CSRGraph::build(std::span<Vertex *const> vertexSet) {
+    const int n = static_cast<int>(vertexSet.size());
+
+    std::vector<int> offsets(n + 1, 0);
+    ids.resize(n);
+    parks.resize(n);
+    for (auto v : vertexSet) {
+        offsets[v->getIndex() + 1] = static_cast<int>(v->getAdj().size());
+        ids[v->getIndex()] = v->getId();
+        parks[v->getIndex()] = v->isPark();
+    }
+    for (int u = 0; u < n; u++) {
+        offsets[u + 1] += offsets[u];
+    }
+
+    const int m = offsets[n];
+    std::vector<int> sources(m), targets(m);
+    std::vector<double> driveTimes(m), walkTimes(m);
+    for (auto v : vertexSet) {
+        int e = offsets[v->getIndex()];
+        for (auto edge : v->getAdj()) {
+            sources[e] = v->getIndex();
+            targets[e] = edge->getDest()->getIndex();
+            driveTimes[e] = edge->getDrive();
+            walkTimes[e] = edge->getWalk();
+            e++;
+        }
+    }
+    this->offsets = std::move(offsets);
+    this->sources = std::move(sources);
+    this->targets = std::move(targets);
+    this->driveTimes = std::move(driveTimes);
+    this->walkTimes = std::move(walkTimes);
+    mapping.reset();
+    buildIncoming();
+    buildParkingSpots();
+    buildIntegral();
+    version = nextVersion();
+}
+
+void CSRGraph::build(std::span<Vertex *const> vertexSet, std::vector<int> &&offsets, std::vector<int> &&sources,
+                     std::vector<int> &&targets, std::vector<double> &&driveTimes, std::vector<double> &&walkTimes,
+                     std::vector<int> &&inOffsets, std::vector<int> &&inEdges) {
+    this->offsets = std::move(offsets);
+    this->sources = std::move(sources);
+    this->targets = std::move(targets);
+    this->driveTimes = std::move(driveTimes);
+    this->walkTimes = std::move(walkTimes);
+    this->inOffsets = std::move(inOffsets);
+    this->inEdges = std::move(inEdges);
+    mapping.reset();
+    ids.resize(vertexSet.size());
+    parks.resize(vertexSet.size());
+    for (auto v : vertexSet) {
+        ids[v->getIndex()] = v->getId();
+        parks[v->getIndex()] = v->isPark();
+    }
+    buildParkingSpots();
+    buildIntegral();
+    version = nextVersion();
+}
+
+void CSRGraph::buildIncoming() {
+    const int n = numVertices(), m = numEdges();
+    std::vector<int> inOffsets(n + 1, 0);
+    for (int e = 0; e < m; e++)
+        inOffsets[targets[e] + 1]++;
+    for (int u = 0; u < n; u++)
+        inOffsets[u + 1] += inOffsets[u];
+
+    std::vector<int> inEdges(m);
+    std::vector<int> next(inOffsets.begin(), inOffsets.end() - 1);
+    for (int e = 0; e < m; e++)
+        inEdges[next[targets[e]]++] = e;
+    this->inOffsets = std::move(inOffsets);
+    this->inEdges = std::move(inEdges);
+}
+
+void CSRGraph::buildParkingSpots() {
+    parkList.clear();
+    for (int u = 0; u < numVertices(); u++)
+        if (parks[u]) parkList.push_back(u);
+}
+
+void CSRGraph::buildIntegral() {
+    const int m = numEdges();
+    integral = false;
+    maxDrive = maxWalk = 0;
+
+    // Whole numbers (or -1) that fit comfortably, so that minutes(e) is exactly times[e]
+    auto whole = [](double t) { return t == -1 || (t >= 0 && t <= INT32_MAX && t == static_cast<int32_t>(t)); };
+    for (int e = 0; e < m; e++) {
+        if (!whole(driveTimes[e]) || !whole(walkTimes[e]))
+            return;
+        maxDrive = std::max(maxDrive, static_cast<int32_t>(driveTimes[e]));
+        maxWalk = std::max(maxWalk, static_cast<int32_t>(walkTimes[e]));
+    }
+    // A shortest path has at most V - 1 edges
+    const int64_t longest = static_cast<int64_t>(std::max(maxDrive, maxWalk)) * std::max(numVertices() - 1, 0);
+    if (longest > INT32_MAX)
+        return;
+    integral = true;
+}
@@ -0,0 +1,337 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <ranges>
+#include <span>
+
+class Vertex;
+class MappedFile;
+
+/**
+ * @brief Modes of travel. Besides the usual int mode parameters, they are used as template arguments, so the
+ * search loops are compiled once per mode with no branch on it.
+ */
+constexpr int DRIVING = 0;
+constexpr int WALKING = 1;
+
+/**
+ * @brief Immutable compressed sparse row (CSR) view of a Graph.
+ *
+ * @details Vertices are addressed by their dense index (position in the vertex set) and the outgoing
+ * edges of vertex u are stored contiguously in [begin(u), end(u)). Edge targets and weights live in
+ * parallel arrays, so the search loops only read flat memory instead of following Edge and Vertex pointers.
+ * The position of an edge in these arrays is its stable edge id.
+ *
+ * When every time is a whole number (as in the provided datasets), the integer search of dijkstra() can run on
+ * them with a bucket queue; it reads the same double times, which convert exactly, so no second copy is kept.
+ *
+ * The edge arrays are either owned or, for a graph loaded from a GraphSnapshot, read in place from the mapped
+ * snapshot file, which the CSR then keeps mapped.
+ */
+class CSRGraph {
+public:
+    /**
+     * @brief Builds the CSR arrays from a vertex set.
+     *
+     * @details The order of the outgoing edges of each vertex is preserved, so searches over the CSR
+     * explore neighbours in the same order as over the pointer-based adjacency lists.
+     *
+     * @param vertexSet The vertices of the graph, each with its dense index already set.
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    void build(std::span<Vertex *const> vertexSet);
+
+    /**
+     * @brief Builds the CSR from edge arrays that are already grouped by origin and by destination.
+     *
+     * @param vertexSet The vertices of the graph, each with its dense index already set.
+     * @param offsets offsets[u]..offsets[u+1] are the edges of vertex u (V + 1 entries).
+     * @param sources Origin of each edge.
+     * @param targets Destination of each edge.
+     * @param driveTimes Driving time of each edge.
+     * @param walkTimes Walking time of each edge.
+     * @param inOffsets inOffsets[u]..inOffsets[u+1] are the positions in inEdges of the edges arriving at u.
+     * @param inEdges Edge ids grouped by destination, in increasing order within each group (see incoming(...)).
+     *
+     * @note Time Complexity: O(V + E) to check the integer times (see isIntegral()), the edge arrays are moved in.
+     */
+    void build(std::span<Vertex *const> vertexSet, std::vector<int> &&offsets, std::vector<int> &&sources,
+               std::vector<int> &&targets, std::vector<double> &&driveTimes, std::vector<double> &&walkTimes,
+               std::vector<int> &&inOffsets, std::vector<int> &&inEdges);
+
+    /**
+     * @brief Gets the number of vertices.
+     *
+     * @return The number of vertices.
+     */
+    int numVertices() const { return static_cast<int>(ids.size()); }
+
+    /**
+     * @brief Gets the number of edges.
+     *
+     * @return The number of edges.
+     */
+    int numEdges() const { return static_cast<int>(targets.size()); }
+
+    /**
+     * @brief Gets the id of the first outgoing edge of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @return The edge id of the first outgoing edge.
+     */
+    int begin(int u) const { return offsets[u]; }
+
+    /**
+     * @brief Gets the id one past the last outgoing edge of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @return The edge id one past the last outgoing edge.
+     */
+    int end(int u) const { return offsets[u + 1]; }
+
+    /**
+     * @brief Gets the outgoing edges of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @return A view over the ids of the outgoing edges (no allocation).
+     */
+    std::ranges::iota_view<int, int> edges(int u) const { return {offsets[u], offsets[u + 1]}; }
+
+    /**
+     * @brief Gets the incoming edges of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @return A view over the ids of the edges whose destination is u, in increasing order.
+     */
+    std::span<const int> incoming(int u) const {
+        return inEdges.span().subspan(inOffsets[u], inOffsets[u + 1] - inOffsets[u]);
+    }
+
+    /**
+     * @brief Gets the origin of an edge.
+     *
+     * @param e The edge id.
+     * @return The dense index of the origin vertex.
+     */
+    int source(int e) const { return sources[e]; }
+
+    /**
+     * @brief Gets the destination of an edge.
+     *
+     * @param e The edge id.
+     * @return The dense index of the destination vertex.
+     */
+    int target(int e) const { return targets[e]; }
+
+    /**
+     * @brief Gets the driving time of an edge.
+     *
+     * @param e The edge id.
+     * @return The driving time, or -1 if driving is not possible.
+     */
+    double drive(int e) const { return driveTimes[e]; }
+
+    /**
+     * @brief Gets the walking time of an edge.
+     *
+     * @param e The edge id.
+     * @return The walking time.
+     */
+    double walk(int e) const { return walkTimes[e]; }
+
+    /**
+     * @brief Gets the time of an edge for a given mode.
+     *
+     * @param e The edge id.
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return The time as a double.
+     */
+    double time(int e, int mode) const { return mode == 0 ? driveTimes[e] : walkTimes[e]; }
+
+    /**
+     * @brief Gets the time of an edge for a mode known at compile time.
+     *
+     * @tparam Mode DRIVING or WALKING.
+     * @param e The edge id.
+     * @return The time as a double.
+     */
+    template <int Mode>
+    double time(int e) const {
+        if constexpr (Mode == DRIVING) return driveTimes[e];
+        else return walkTimes[e];
+    }
+
+    /**
+     * @brief Checks if every edge time is a whole number.
+     *
+     * @details Only true if, in addition, no path can add up to more than INT32_MAX, so integer distances
+     * never overflow.
+     *
+     * @return True if minutes(...) is exact, false otherwise.
+     */
+    bool isIntegral() const { return integral; }
+
+    /**
+     * @brief Gets the time of an edge for a given mode as an integer (only if isIntegral()).
+     *
+     * @param e The edge id.
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return The time, or -1 if the edge cannot be used in this mode.
+     */
+    int32_t minutes(int e, int mode) const { return static_cast<int32_t>(time(e, mode)); }
+
+    /**
+     * @brief Gets the integer time of an edge for a mode known at compile time (only if isIntegral()).
+     *
+     * @tparam Mode DRIVING or WALKING.
+     * @param e The edge id.
+     * @return The time, or -1 if the edge cannot be used in this mode.
+     */
+    template <int Mode>
+    int32_t minutes(int e) const { return static_cast<int32_t>(time<Mode>(e)); }
+
+    /**
+     * @brief Gets the largest integer time of a mode (only if isIntegral()).
+     *
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return The largest edge time of the mode.
+     */
+    int32_t maxMinutes(int mode) const { return mode == 0 ? maxDrive : maxWalk; }
+
+    /**
+     * @brief Gets the external id of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @return The id read from the locations file.
+     */
+    int id(int u) const { return ids[u]; }
+
+    /**
+     * @brief Checks if a vertex is a parking spot.
+     *
+     * @param u The dense index of the vertex.
+     * @return True if the vertex is a park, false otherwise.
+     */
+    bool isPark(int u) const { return parks[u] != 0; }
+
+    /**
+     * @brief Gets the parking spots.
+     *
+     * @return The dense indices of every vertex that is a park, in increasing order.
+     */
+    std::span<const int> parkingSpots() const { return parkList; }
+
+    /**
+     * @brief Gets the version of the graph, a number that changes every time its arrays are built.
+     *
+     * @details Data derived from a graph (such as cached search trees) keeps the version it was computed for,
+     * since a graph reloaded in place may have the same address and sizes but different times.
+     *
+     * @return The version (0 for a graph that was never built).
+     */
+    std::uint64_t getVersion() const { return version; }
+
+private:
+    friend class GraphSnapshot;
+
+    /**
+     * @brief An array of the CSR: a vector it owns, or a view into the snapshot file it was loaded from.
+     *
+     * @details Copies and moves keep pointing to the mapped file, which the CSR shares (see mapping), or to
+     * their own copy of the vector.
+     */
+    template <class T>
+    class Array {
+    public:
+        Array() = default;
+        Array(const Array &other) : owned(other.owned), items(other.isOwned() ? std::span<const T>(owned) : other.items) { }
+        Array(Array &&other) noexcept { *this = std::move(other); }
+        Array &operator=(const Array &other) {
+            if (this != &other) {
+                owned = other.owned;
+                items = other.isOwned() ? std::span<const T>(owned) : other.items;
+            }
+            return *this;
+        }
+        Array &operator=(Array &&other) noexcept {
+            if (this == &other) return *this;
+            const bool wasOwned = other.isOwned();
+            owned = std::move(other.owned);
+            items = wasOwned ? std::span<const T>(owned) : other.items;
+            other.owned.clear();
+            other.items = {};
+            return *this;
+        }
+        Array &operator=(std::vector<T> &&v) {
+            owned = std::move(v);
+            items = owned;
+            return *this;
+        }
+
+        /**
+         * @brief Reads the array in place from mapped memory, which must outlive it.
+         */
+        void view(std::span<const T> mapped) {
+            owned.clear();
+            items = mapped;
+        }
+
+        const T &operator[](std::size_t i) const { return items[i]; }
+        std::size_t size() const { return items.size(); }
+        std::span<const T> span() const { return items; }
+
+    private:
+        bool isOwned() const { return items.data() == owned.data(); }
+
+        std::vector<T> owned;      ///< The elements, unless they are mapped.
+        std::span<const T> items;  ///< The elements: owned or mapped.
+    };
+
+    /**
+     * @brief Gets a version number never returned before.
+     */
+    static std::uint64_t nextVersion();
+
+    /**
+     * @brief Groups the edge ids by destination, for incoming(...).
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    void buildIncoming();
+
+    /**
+     * @brief Lists the vertices whose park flag is set, for parkingSpots().
+     *
+     * @note Time Complexity: O(V).
+     */
+    void buildParkingSpots();
+
+    /**
+     * @brief Checks if every time is a whole number and finds the largest ones (see isIntegral()).
+     *
+     * @note Time Complexity: O(E).
+     */
+    void buildIntegral();
+
+    Array<int> offsets;              ///< offsets[u]..offsets[u+1] are the outgoing edges of u.
+    Array<int> sources;              ///< Origin of each edge.
+    Array<int> targets;              ///< Destination of each edge.
+    Array<int> inOffsets;            ///< inOffsets[u]..inOffsets[u+1] are the positions of the incoming edges of u.
+    Array<int> inEdges;              ///< Edge ids grouped by destination.
+    Array<double> driveTimes;        ///< Driving time of each edge (-1 if not drivable).
+    Array<double> walkTimes;         ///< Walking time of each edge.
+    std::shared_ptr<const MappedFile> mapping;  ///< The snapshot file the arrays are read from, if any.
+    std::vector<int> ids;            ///< External id of each vertex.
+    std::vector<char> parks;         ///< Park flag of each vertex.
+    std::vector<int> parkList;       ///< Dense indices of the parks.
+    int32_t maxDrive = 0;               ///< Largest driving time.
+    int32_t maxWalk = 0;                ///< Largest walking time.
+    bool integral = false;              ///< See isIntegral().
+    std::uint64_t version = 0;          ///< See getVersion().
+};
+
+#endif //CSRGRAPH_H
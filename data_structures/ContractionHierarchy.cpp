@@ -0,0 +1,270 @@
+#include "ContractionHierarchy.h"
+#include "IndexedPriorityQueue.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace {
+
+constexpr int WITNESS_SETTLE_LIMIT = 500; // a shortcut is added when the witness search gives up
+
+// Shortest distances from a vertex in the graph being contracted, reusing its arrays between searches
+struct WitnessSearch {
+    std::vector<double> dist;
+    std::vector<int> touched;
+
+    explicit WitnessSearch(int n) : dist(n, INF) { }
+
+    void clear() {
+        for (int v : touched) dist[v] = INF;
+        touched.clear();
+    }
+};
+
+}
+
+void ContractionHierarchy::build(const CSRGraph &csr, const int mode) {
+    const int n = csr.numVertices();
+    this->mode = mode;
+    arcs.clear();
+    rank.assign(n, -1);
+
+    // Arcs of the graph that is left, by vertex. Superseded arcs are removed from these lists but kept in
+    // arcs, since a shortcut may still refer to them.
+    std::vector<std::vector<int>> out(n), in(n);
+    std::vector<char> alive;
+    auto findArc = [&](int u, int w) {
+        for (int a : out[u])
+            if (arcs[a].to == w) return a;
+        return -1;
+    };
+    auto addArc = [&](const Arc &arc) {
+        int old = findArc(arc.from, arc.to);
+        if (old != -1) {
+            if (arcs[old].weight <= arc.weight) return; // keep the first of the fastest parallel edges
+            alive[old] = false;
+            std::erase(out[arc.from], old);
+            std::erase(in[arc.to], old);
+        }
+        arcs.push_back(arc);
+        alive.push_back(true);
+        out[arc.from].push_back(static_cast<int>(arcs.size()) - 1);
+        in[arc.to].push_back(static_cast<int>(arcs.size()) - 1);
+    };
+
+    for (int u = 0; u < n; u++) {
+        for (int e : csr.edges(u)) {
+            if (csr.time(e, mode) == -1 || csr.target(e) == u) continue;
+            addArc({u, csr.target(e), csr.time(e, mode), e, -1, -1});
+        }
+    }
+    originalArcs = static_cast<int>(arcs.size());
+
+    // Shortcuts needed to contract v; they are added only if apply is true
+    WitnessSearch ws(n);
+    auto contract = [&](int v, bool apply) {
+        int count = 0;
+        std::vector<Arc> found;
+        for (int a : in[v]) {
+            const int u = arcs[a].from;
+            if (rank[u] != -1) continue;
+            double limit = -1;
+            for (int b : out[v])
+                if (rank[arcs[b].to] == -1 && arcs[b].to != u) limit = std::max(limit, arcs[a].weight + arcs[b].weight);
+            if (limit == -1) continue; // no neighbour to connect u to
+
+            // Bounded Dijkstra from u that does not go through v
+            using Item = std::pair<double, int>;
+            std::priority_queue<Item, std::vector<Item>, std::greater<>> q;
+            ws.clear();
+            ws.dist[u] = 0;
+            ws.touched.push_back(u);
+            q.emplace(0, u);
+            int settled = 0;
+            while (!q.empty() && settled < WITNESS_SETTLE_LIMIT) {
+                auto [d, x] = q.top();
+                q.pop();
+                if (d > ws.dist[x]) continue;
+                if (d > limit) break;
+                settled++;
+                for (int c : out[x]) {
+                    const int y = arcs[c].to;
+                    if (y == v || rank[y] != -1) continue;
+                    if (d + arcs[c].weight < ws.dist[y]) {
+                        if (ws.dist[y] == INF) ws.touched.push_back(y);
+                        ws.dist[y] = d + arcs[c].weight;
+                        q.emplace(ws.dist[y], y);
+                    }
+                }
+            }
+
+            for (int b : out[v]) {
+                const int w = arcs[b].to;
+                if (rank[w] != -1 || w == u) continue;
+                const double through = arcs[a].weight + arcs[b].weight;
+                if (ws.dist[w] <= through) continue; // a witness path is at least as fast
+                count++;
+                if (apply) found.push_back({u, w, through, -1, a, b});
+            }
+        }
+        for (const Arc &arc : found) addArc(arc);
+        return count;
+    };
+
+    std::vector<int> contractedNeighbours(n, 0);
+    auto priority = [&](int v) {
+        int degree = 0;
+        for (int a : in[v]) degree += rank[arcs[a].from] == -1;
+        for (int a : out[v]) degree += rank[arcs[a].to] == -1;
+        return contract(v, false) - degree + contractedNeighbours[v];
+    };
+
+    // Lazy updates: a vertex is contracted only if its priority is still the smallest when recomputed
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> order;
+    for (int v = 0; v < n; v++) order.emplace(priority(v), v);
+    int next = 0;
+    while (!order.empty()) {
+        const int v = order.top().second;
+        order.pop();
+        if (rank[v] != -1) continue;
+        const int p = priority(v);
+        if (!order.empty() && p > order.top().first) {
+            order.emplace(p, v);
+            continue;
+        }
+        contract(v, true);
+        rank[v] = next++;
+        for (int a : in[v]) contractedNeighbours[arcs[a].from]++;
+        for (int a : out[v]) contractedNeighbours[arcs[a].to]++;
+    }
+
+    // Search graph: each remaining arc goes upwards from its lower ranked end
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (int a = 0; a < static_cast<int>(arcs.size()); a++) {
+        if (!alive[a]) continue;
+        if (rank[arcs[a].from] < rank[arcs[a].to]) upOffsets[arcs[a].from + 1]++;
+        else downOffsets[arcs[a].to + 1]++;
+    }
+    for (int u = 0; u < n; u++) {
+        upOffsets[u + 1] += upOffsets[u];
+        downOffsets[u + 1] += downOffsets[u];
+    }
+    upArcs.resize(upOffsets[n]);
+    downArcs.resize(downOffsets[n]);
+    std::vector<int> upNext(upOffsets.begin(), upOffsets.end() - 1), downNext(downOffsets.begin(), downOffsets.end() - 1);
+    for (int a = 0; a < static_cast<int>(arcs.size()); a++) {
+        if (!alive[a]) continue;
+        if (rank[arcs[a].from] < rank[arcs[a].to]) upArcs[upNext[arcs[a].from]++] = a;
+        else downArcs[downNext[arcs[a].to]++] = a;
+    }
+}
+
+double ContractionHierarchy::query(SearchContext &ctx, const int s, const int t, std::vector<int> &edges) const {
+    edges.clear();
+    SearchContext::Layer &fwd = ctx.drive, &bwd = ctx.back;
+    SearchContext::reset(fwd);
+    SearchContext::reset(bwd);
+    auto dist = [](const SearchContext::Layer &l, int v) { return l.stamp[v] == l.epoch ? l.dist[v] : INF; };
+    auto set = [](SearchContext::Layer &l, int v, double d, int arc) { l.dist[v] = d; l.path[v] = arc; l.stamp[v] = l.epoch; };
+
+    set(fwd, s, 0, -1);
+    set(bwd, t, 0, -1);
+    IndexedPriorityQueue qf(fwd.dist, ctx.queueIndex), qb(bwd.dist, ctx.backQueueIndex);
+    qf.insert(s);
+    qb.insert(t);
+
+    double best = INF; // length of the best route found so far
+    int meet = -1;     // its highest vertex
+
+    // Each side stops once its smallest key cannot improve the best route
+    while (true) {
+        const bool forward = !qf.empty() && fwd.dist[qf.top()] < best;
+        const bool backward = !qb.empty() && bwd.dist[qb.top()] < best;
+        if (!forward && !backward) break;
+        const bool isForward = forward && (!backward || fwd.dist[qf.top()] <= bwd.dist[qb.top()]);
+
+        SearchContext::Layer &l = isForward ? fwd : bwd;
+        const SearchContext::Layer &other = isForward ? bwd : fwd;
+        const int v = isForward ? qf.extractMin() : qb.extractMin();
+        if (dist(other, v) != INF && l.dist[v] + dist(other, v) < best) {
+            best = l.dist[v] + dist(other, v);
+            meet = v;
+        }
+
+        const int first = isForward ? upOffsets[v] : downOffsets[v];
+        const int last = isForward ? upOffsets[v + 1] : downOffsets[v + 1];
+        for (int i = first; i < last; i++) {
+            const int a = isForward ? upArcs[i] : downArcs[i];
+            const int w = isForward ? arcs[a].to : arcs[a].from;
+            const double d = l.dist[v] + arcs[a].weight;
+            if (d < dist(l, w)) {
+                const bool inQueue = dist(l, w) != INF;
+                set(l, w, d, a);
+                if (isForward) inQueue ? qf.decreaseKey(w) : qf.insert(w);
+                else inQueue ? qb.decreaseKey(w) : qb.insert(w);
+            }
+        }
+    }
+    if (meet == -1)
+        return INF;
+
+    // Arcs from s up to the meeting vertex, then down to t
+    std::vector<int> route;
+    for (int v = meet; fwd.path[v] != -1; v = arcs[fwd.path[v]].from)
+        route.push_back(fwd.path[v]);
+    std::reverse(route.begin(), route.end());
+    for (int v = meet; bwd.path[v] != -1; v = arcs[bwd.path[v]].to)
+        route.push_back(bwd.path[v]);
+    for (int a : route)
+        unpack(a, edges);
+    return best;
+}
+
+void ContractionHierarchy::upwardSearch(SearchContext &ctx, const int u, const bool forward,
+                                        std::vector<std::pair<int, double>> &space) const {
+    space.clear();
+    SearchContext::Layer &l = forward ? ctx.drive : ctx.back;
+    SearchContext::reset(l);
+    auto dist = [&](int v) { return l.stamp[v] == l.epoch ? l.dist[v] : INF; };
+
+    l.dist[u] = 0;
+    l.path[u] = -1;
+    l.stamp[u] = l.epoch;
+    IndexedPriorityQueue q(l.dist, forward ? ctx.queueIndex : ctx.backQueueIndex);
+    q.insert(u);
+    while (!q.empty()) {
+        const int v = q.extractMin();
+        space.emplace_back(v, l.dist[v]);
+        const int first = forward ? upOffsets[v] : downOffsets[v];
+        const int last = forward ? upOffsets[v + 1] : downOffsets[v + 1];
+        for (int i = first; i < last; i++) {
+            const int a = forward ? upArcs[i] : downArcs[i];
+            const int w = forward ? arcs[a].to : arcs[a].from;
+            const double d = l.dist[v] + arcs[a].weight;
+            if (d < dist(w)) {
+                const bool inQueue = dist(w) != INF;
+                l.dist[w] = d;
+                l.path[w] = a;
+                l.stamp[w] = l.epoch;
+                inQueue ? q.decreaseKey(w) : q.insert(w);
+            }
+        }
+    }
+}
+
+void ContractionHierarchy::unpack(const int arc, std::vector<int> &edges) const {
+    std::vector<int> stack = {arc};
+    while (!stack.empty()) {
+        const Arc &a = arcs[stack.back()];
+        stack.pop_back();
+        if (a.edge != -1) {
+            edges.push_back(a.edge);
+        } else {
+            stack.push_back(a.second);
+            stack.push_back(a.first);
+        }
+    }
+}
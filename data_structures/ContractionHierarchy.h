@@ -0,0 +1,113 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <utility>
+#include <vector>
+#include "CSRGraph.h"
+#include "SearchContext.h"
+
+/**
+ * @brief Contraction Hierarchy over the times of one mode of travel (driving by default).
+ *
+ * @details Vertices are contracted one at a time, cheapest first (edge difference plus the number of contracted
+ * neighbours, updated lazily). Contracting v adds a shortcut u->w for every pair of remaining neighbours whose
+ * shortest path goes through v, which a bounded witness search decides. The rank of a vertex is its position in
+ * that order.
+ * A query is a bidirectional Dijkstra that only climbs: forward over the arcs to higher ranked vertices and
+ * backward over the arcs from higher ranked vertices, so it settles a few dozen vertices instead of the whole
+ * graph. Shortcuts remember the two arcs they replace, so the path found is unpacked into original edges.
+ * Edges that cannot be used in the mode (time -1) are left out.
+ */
+class ContractionHierarchy {
+public:
+    /**
+     * @brief Builds the hierarchy.
+     *
+     * @param csr The graph.
+     * @param mode The mode of travel whose times are used (0 for driving, 1 for walking).
+     *
+     * @note Time Complexity: depends on the graph, roughly O(V * d^2 * w) where d is the degree of the vertices
+     * when they are contracted and w the size of a witness search.
+     */
+    void build(const CSRGraph &csr, int mode = DRIVING);
+
+    /**
+     * @brief Checks if the hierarchy was built.
+     *
+     * @return True if build(...) was called for a graph with at least one vertex.
+     */
+    bool isBuilt() const { return !rank.empty(); }
+
+    /**
+     * @brief Gets the mode of travel the hierarchy was built for.
+     *
+     * @return 0 for driving, 1 for walking.
+     */
+    int getMode() const { return mode; }
+
+    /**
+     * @brief Finds the fastest route between two vertices, in the mode of the hierarchy.
+     *
+     * @param ctx Search state (the driving and backward layers and the queue positions are used).
+     * @param s The dense index of the origin.
+     * @param t The dense index of the destination.
+     * @param edges Where the CSR ids of the edges of the route are stored, in order (empty if there is no route).
+     * @return The time of the route, or INF if there is none.
+     *
+     * @note Time Complexity: O((V'+E')logV') where V' and E' are the vertices and arcs above s and t in the
+     * hierarchy, plus the length of the unpacked route.
+     */
+    double query(SearchContext &ctx, int s, int t, std::vector<int> &edges) const;
+
+    /**
+     * @brief Settles every vertex that can be reached from (or that reaches) a vertex by climbing the hierarchy.
+     *
+     * @details The fastest route between s and t goes through its highest ranked vertex, which is in both the
+     * forward space of s and the backward space of t with its exact distances, so the time of the route is the
+     * minimum of d(s, v) + d(v, t) over the vertices v in both. Used by the many-to-many tables.
+     *
+     * @param ctx Search state (the driving layer, or the backward layer if !forward, and the queue positions are used).
+     * @param u The dense index of the vertex.
+     * @param forward True to follow the arcs out of u, false to follow them backwards into u.
+     * @param space Where the settled vertices and their distances from (or to) u are stored, in settle order.
+     *
+     * @note Time Complexity: O((V'+E')logV') where V' and E' are the vertices and arcs above u in the hierarchy.
+     */
+    void upwardSearch(SearchContext &ctx, int u, bool forward, std::vector<std::pair<int, double>> &space) const;
+
+    /**
+     * @brief Gets the number of shortcuts added by the contraction.
+     *
+     * @return The number of shortcuts.
+     */
+    int numShortcuts() const { return static_cast<int>(arcs.size()) - originalArcs; }
+
+private:
+    /**
+     * @brief An arc of the hierarchy: an original edge or a shortcut over two arcs.
+     */
+    struct Arc {
+        int from;           ///< Origin vertex.
+        int to;             ///< Destination vertex.
+        double weight;      ///< Driving time.
+        int edge;           ///< CSR id of the original edge, or -1 for a shortcut.
+        int first;          ///< For a shortcut, the arc from -> middle.
+        int second;         ///< For a shortcut, the arc middle -> to.
+    };
+
+    /**
+     * @brief Appends the original edges of an arc to a route.
+     */
+    void unpack(int arc, std::vector<int> &edges) const;
+
+    int mode = DRIVING;         ///< Mode of travel whose times are used.
+    std::vector<Arc> arcs;      ///< Original arcs first, then shortcuts.
+    int originalArcs = 0;       ///< Number of arcs that are original edges.
+    std::vector<int> rank;      ///< Contraction order of each vertex.
+    std::vector<int> upOffsets; ///< upOffsets[u]..upOffsets[u+1] are the arcs from u to higher ranked vertices.
+    std::vector<int> upArcs;    ///< Arc ids grouped by origin.
+    std::vector<int> downOffsets; ///< downOffsets[u]..downOffsets[u+1] are the arcs into u from higher ranked vertices.
+    std::vector<int> downArcs;  ///< Arc ids grouped by destination.
+};
+
+#endif //CONTRACTIONHIERARCHY_H
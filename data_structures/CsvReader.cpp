@@ -0,0 +1,136 @@
+#include "CsvReader.h"
+
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/************************* MappedFile  **************************/
+
+MappedFile::MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return;
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        open = true;
+        size = static_cast<std::size_t>(st.st_size);
+        if (size > 0) {
+            void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                open = false;
+                size = 0;
+            } else {
+                data = static_cast<const char *>(p);
+                madvise(p, size, MADV_SEQUENTIAL);
+            }
+        }
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), size);
+}
+
+bool MappedFile::isOpen() const {
+    return open;
+}
+
+std::string_view MappedFile::view() const {
+    return {data, size};
+}
+
+/************************* CsvReader  **************************/
+
+CsvReader::CsvReader(std::string_view text) : text(text) { }
+
+int CsvReader::nextRecord(std::string_view *fields, int maxFields) {
+    const std::size_t n = text.size();
+
+    // Skip empty lines
+    while (pos < n && (text[pos] == '\n' || text[pos] == '\r')) {
+        if (text[pos] == '\n') line++;
+        pos++;
+    }
+    if (pos >= n)
+        return -1;
+    recordLine = line + 1;
+
+    int count = 0;
+    while (true) {
+        std::string_view field;
+        if (pos < n && text[pos] == '"') {
+            const std::size_t start = ++pos;
+            while (pos < n) {
+                if (text[pos] == '"') {
+                    if (pos + 1 < n && text[pos + 1] == '"') { pos += 2; continue; } // escaped quote
+                    break;
+                }
+                if (text[pos] == '\n') line++;
+                pos++;
+            }
+            field = text.substr(start, pos - start);
+            if (pos < n) pos++; // closing quote
+            while (pos < n && text[pos] != ',' && text[pos] != '\n' && text[pos] != '\r') pos++;
+        } else {
+            const std::size_t start = pos;
+            while (pos < n && text[pos] != ',' && text[pos] != '\n') pos++;
+            std::size_t end = pos;
+            if (end > start && text[end - 1] == '\r') end--;
+            field = text.substr(start, end - start);
+        }
+
+        if (count < maxFields) fields[count] = field;
+        count++;
+
+        if (pos < n && text[pos] == ',') {
+            pos++;
+            continue;
+        }
+        // End of the record
+        if (pos < n && text[pos] == '\r') pos++;
+        if (pos < n && text[pos] == '\n') { pos++; line++; }
+        return count;
+    }
+}
+
+int CsvReader::getLine() const {
+    return recordLine;
+}
+
+std::size_t CsvReader::getPosition() const {
+    return pos;
+}
+
+std::string CsvReader::unquote(std::string_view field) {
+    std::string res;
+    res.reserve(field.size());
+    for (std::size_t i = 0; i < field.size(); i++) {
+        res += field[i];
+        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') i++;
+    }
+    return res;
+}
+
+/************************* Number parsing  **************************/
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+bool parseInt(std::string_view field, int &value) {
+    field = trim(field);
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc() && ptr == field.data() + field.size() && !field.empty();
+}
+
+bool parseDouble(std::string_view field, double &value) {
+    field = trim(field);
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return ec == std::errc() && ptr == field.data() + field.size() && !field.empty();
+}
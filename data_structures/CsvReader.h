@@ -0,0 +1,120 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * @details The file is mapped with mmap, so reading it costs no copy into a user buffer. The mapping is
+ * released by the destructor.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file into memory.
+     *
+     * @param path The path of the file.
+     */
+    explicit MappedFile(const std::string &path);
+
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Checks if the file could be opened.
+     *
+     * @return True if the file was opened (an empty file counts as opened), false otherwise.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the contents of the file.
+     *
+     * @return A view over the mapped bytes.
+     */
+    std::string_view view() const;
+
+private:
+    const char *data = nullptr;  ///< Start of the mapping (nullptr for an empty file).
+    std::size_t size = 0;        ///< Size of the file in bytes.
+    bool open = false;           ///< Whether the file could be opened.
+};
+
+/**
+ * @brief Splits CSV text into records and fields without copying it.
+ *
+ * @details Fields are returned as views into the original text. LF and CRLF line endings are accepted and
+ * empty lines are skipped. A field may be quoted ("...") to contain commas, line breaks or quotes (written as
+ * ""); the returned view then excludes the outer quotes but still has the doubled quotes, which unquote()
+ * turns into a string.
+ */
+class CsvReader {
+public:
+    /**
+     * @brief Creates a reader over some CSV text.
+     *
+     * @param text The CSV contents, which must outlive the reader and the fields it returns.
+     */
+    explicit CsvReader(std::string_view text);
+
+    /**
+     * @brief Reads the next non-empty record.
+     *
+     * @param fields Array where the first maxFields fields of the record are stored.
+     * @param maxFields The capacity of fields; extra fields are ignored.
+     * @return The number of fields in the record (may exceed maxFields), or -1 at the end of the text.
+     */
+    int nextRecord(std::string_view *fields, int maxFields);
+
+    /**
+     * @brief Gets the line number of the last record read (1-based).
+     *
+     * @return The line number.
+     */
+    int getLine() const;
+
+    /**
+     * @brief Gets the position in the text where the next record starts.
+     *
+     * @return The offset of the next character to read.
+     */
+    std::size_t getPosition() const;
+
+    /**
+     * @brief Turns a field into a string, replacing each "" by a single quote.
+     *
+     * @param field A field returned by nextRecord.
+     * @return The unescaped field.
+     */
+    static std::string unquote(std::string_view field);
+
+private:
+    std::string_view text;  ///< The CSV contents.
+    std::size_t pos = 0;    ///< Position of the next character to read.
+    int line = 0;           ///< Line where the next record starts, minus one.
+    int recordLine = 0;     ///< Line of the last record read.
+};
+
+/**
+ * @brief Parses an integer field with std::from_chars, ignoring surrounding spaces.
+ *
+ * @param field The field to parse.
+ * @param value Where the parsed value is stored.
+ * @return True if the whole field is a valid integer, false otherwise.
+ */
+bool parseInt(std::string_view field, int &value);
+
+/**
+ * @brief Parses a decimal field with std::from_chars, ignoring surrounding spaces.
+ *
+ * @param field The field to parse.
+ * @param value Where the parsed value is stored.
+ * @return True if the whole field is a valid number, false otherwise.
+ */
+bool parseDouble(std::string_view field, double &value);
+
+#endif //CSVREADER_H
@@ -0,0 +1,256 @@
+#include "CustomizableHierarchy.h"
+#include "IndexedPriorityQueue.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <queue>
+
+void CustomizableHierarchy::build(const CSRGraph &csr) {
+    const int n = csr.numVertices();
+    rank.assign(n, -1);
+
+    // Undirected graph of the drivable edges: only its shape matters for the order
+    std::vector<std::vector<int>> adj(n);
+    for (int u = 0; u < n; u++) {
+        for (int e : csr.edges(u)) {
+            if (csr.drive(e) == -1 || csr.target(e) == u) continue;
+            adj[u].push_back(csr.target(e));
+            adj[csr.target(e)].push_back(u);
+        }
+    }
+    for (auto &l : adj) {
+        std::sort(l.begin(), l.end());
+        l.erase(std::unique(l.begin(), l.end()), l.end());
+    }
+
+    // Minimum degree elimination: the neighbours of a vertex when it is eliminated become a clique, and
+    // they are the higher ranked ends of its arcs
+    std::vector<std::vector<int>> upperOf(n);
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> q;
+    for (int v = 0; v < n; v++) q.emplace(adj[v].size(), v);
+    int next = 0;
+    std::vector<int> merged;
+    while (!q.empty()) {
+        auto [degree, v] = q.top();
+        q.pop();
+        if (rank[v] != -1 || degree != static_cast<int>(adj[v].size())) continue; // outdated entry
+        rank[v] = next++;
+        upperOf[v] = std::move(adj[v]);
+        for (int u : upperOf[v]) {
+            merged.clear();
+            std::set_union(adj[u].begin(), adj[u].end(), upperOf[v].begin(), upperOf[v].end(), std::back_inserter(merged));
+            std::erase(merged, u);
+            std::erase(merged, v);
+            adj[u].swap(merged);
+            q.emplace(adj[u].size(), u);
+        }
+        adj[v].clear();
+    }
+
+    // Arcs, grouped by their lower and by their upper end, each group sorted by vertex
+    lower.clear();
+    upper.clear();
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        for (int u : upperOf[v]) {
+            lower.push_back(v);
+            upper.push_back(u);
+            upOffsets[v + 1]++;
+            downOffsets[u + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        upOffsets[u + 1] += upOffsets[u];
+        downOffsets[u + 1] += downOffsets[u];
+    }
+    const int arcs = numArcs();
+    upNeighbours = upper;
+    upArcs.resize(arcs);
+    for (int a = 0; a < arcs; a++) upArcs[a] = a; // arcs were created grouped by lower end, sorted by upper end
+    downNeighbours.resize(arcs);
+    downArcs.resize(arcs);
+    std::vector<int> downNext(downOffsets.begin(), downOffsets.end() - 1);
+    for (int a = 0; a < arcs; a++) { // lower ends come in increasing order, so each group ends up sorted
+        downNeighbours[downNext[upper[a]]] = lower[a];
+        downArcs[downNext[upper[a]]++] = a;
+    }
+
+    // Base customization
+    base = HierarchyMetric();
+    for (auto *w : {&base.up, &base.down}) w->assign(arcs, INF);
+    for (auto *w : {&base.upVia, &base.downVia, &base.upEdge, &base.downEdge}) w->assign(arcs, -1);
+    std::vector<int> byRank(n);
+    for (int v = 0; v < n; v++) byRank[rank[v]] = v;
+    for (int v : byRank)
+        for (int i = upOffsets[v]; i < upOffsets[v + 1]; i++)
+            recompute(csr, base, upArcs[i], nullptr, nullptr);
+}
+
+int CustomizableHierarchy::findArc(int u, int v) const {
+    if (rank[u] > rank[v]) std::swap(u, v);
+    auto first = upNeighbours.begin() + upOffsets[u], last = upNeighbours.begin() + upOffsets[u + 1];
+    auto it = std::lower_bound(first, last, v);
+    return it != last && *it == v ? upArcs[it - upNeighbours.begin()] : -1;
+}
+
+bool CustomizableHierarchy::recompute(const CSRGraph &csr, HierarchyMetric &metric, const int a,
+                                      const AvoidMask *avoidNode, const AvoidMask *avoidEdge) const {
+    const int u = lower[a], v = upper[a];
+    const double oldUp = metric.up[a], oldDown = metric.down[a];
+
+    // Fastest usable original edge in each direction; avoided vertices can be left but not entered
+    auto original = [&](int from, int to, double &weight, int &via, int &edge) {
+        weight = INF;
+        via = -1;
+        edge = -1;
+        if (avoidNode != nullptr && avoidNode->test(to)) return;
+        for (int e : csr.edges(from)) {
+            if (csr.target(e) != to || csr.drive(e) == -1 || (avoidEdge != nullptr && avoidEdge->test(e))) continue;
+            if (csr.drive(e) < weight) {
+                weight = csr.drive(e);
+                edge = e;
+            }
+        }
+    };
+    original(u, v, metric.up[a], metric.upVia[a], metric.upEdge[a]);
+    original(v, u, metric.down[a], metric.downVia[a], metric.downEdge[a]);
+
+    // Lower triangles: vertices x below both ends, joined to both
+    int i = downOffsets[u], j = downOffsets[v];
+    while (i < downOffsets[u + 1] && j < downOffsets[v + 1]) {
+        if (downNeighbours[i] < downNeighbours[j]) { i++; continue; }
+        if (downNeighbours[j] < downNeighbours[i]) { j++; continue; }
+        const int x = downNeighbours[i], xu = downArcs[i], xv = downArcs[j];
+        if (metric.down[xu] + metric.up[xv] < metric.up[a]) { // u -> x -> v
+            metric.up[a] = metric.down[xu] + metric.up[xv];
+            metric.upVia[a] = x;
+        }
+        if (metric.down[xv] + metric.up[xu] < metric.down[a]) { // v -> x -> u
+            metric.down[a] = metric.down[xv] + metric.up[xu];
+            metric.downVia[a] = x;
+        }
+        i++;
+        j++;
+    }
+    return metric.up[a] != oldUp || metric.down[a] != oldDown;
+}
+
+void CustomizableHierarchy::customize(const CSRGraph &csr, HierarchyMetric &metric, const AvoidMask &avoidNode,
+                                      const AvoidMask &avoidEdge) const {
+    metric = base;
+    if (avoidNode.getSetBits().empty() && avoidEdge.getSetBits().empty())
+        return;
+
+    // Arcs are recomputed by increasing rank of their lower end, so the arcs of their lower triangles are final
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> dirty;
+    std::vector<char> queued(numArcs(), false);
+    auto push = [&](int a) {
+        if (a != -1 && !queued[a]) {
+            queued[a] = true;
+            dirty.emplace(rank[lower[a]], a);
+        }
+    };
+    for (int e : avoidEdge.getSetBits())
+        if (csr.drive(e) != -1) push(findArc(csr.source(e), csr.target(e)));
+    for (int z : avoidNode.getSetBits()) {
+        for (int i = upOffsets[z]; i < upOffsets[z + 1]; i++) push(upArcs[i]);
+        for (int i = downOffsets[z]; i < downOffsets[z + 1]; i++) push(downArcs[i]);
+    }
+
+    while (!dirty.empty()) {
+        const int a = dirty.top().second;
+        dirty.pop();
+        if (!recompute(csr, metric, a, &avoidNode, &avoidEdge)) continue;
+        // a is the side of the triangles below the arcs between upper[a] and the other upper neighbours of lower[a]
+        const int u = lower[a], v = upper[a];
+        for (int i = upOffsets[u]; i < upOffsets[u + 1]; i++)
+            if (upNeighbours[i] != v) push(findArc(v, upNeighbours[i]));
+    }
+}
+
+double CustomizableHierarchy::query(SearchContext &ctx, const HierarchyMetric &metric, const int s, const int t,
+                                    std::vector<int> &edges) const {
+    edges.clear();
+    SearchContext::Layer &fwd = ctx.drive, &bwd = ctx.back;
+    SearchContext::reset(fwd);
+    SearchContext::reset(bwd);
+    auto dist = [](const SearchContext::Layer &l, int v) { return l.stamp[v] == l.epoch ? l.dist[v] : INF; };
+    auto set = [](SearchContext::Layer &l, int v, double d, int arc) { l.dist[v] = d; l.path[v] = arc; l.stamp[v] = l.epoch; };
+
+    set(fwd, s, 0, -1);
+    set(bwd, t, 0, -1);
+    IndexedPriorityQueue qf(fwd.dist, ctx.queueIndex), qb(bwd.dist, ctx.backQueueIndex);
+    qf.insert(s);
+    qb.insert(t);
+
+    double best = INF; // length of the best route found so far
+    int meet = -1;     // its highest vertex
+
+    // Both sides only climb: forward with the upward weights, backward with the downward ones
+    while (true) {
+        const bool forward = !qf.empty() && fwd.dist[qf.top()] < best;
+        const bool backward = !qb.empty() && bwd.dist[qb.top()] < best;
+        if (!forward && !backward) break;
+        const bool isForward = forward && (!backward || fwd.dist[qf.top()] <= bwd.dist[qb.top()]);
+
+        SearchContext::Layer &l = isForward ? fwd : bwd;
+        const SearchContext::Layer &other = isForward ? bwd : fwd;
+        const std::vector<double> &weight = isForward ? metric.up : metric.down;
+        const int v = isForward ? qf.extractMin() : qb.extractMin();
+        if (dist(other, v) != INF && l.dist[v] + dist(other, v) < best) {
+            best = l.dist[v] + dist(other, v);
+            meet = v;
+        }
+
+        for (int i = upOffsets[v]; i < upOffsets[v + 1]; i++) {
+            const int a = upArcs[i], w = upNeighbours[i];
+            if (weight[a] == INF) continue;
+            const double d = l.dist[v] + weight[a];
+            if (d < dist(l, w)) {
+                const bool inQueue = dist(l, w) != INF;
+                set(l, w, d, a);
+                if (isForward) inQueue ? qf.decreaseKey(w) : qf.insert(w);
+                else inQueue ? qb.decreaseKey(w) : qb.insert(w);
+            }
+        }
+    }
+    if (meet == -1)
+        return INF;
+
+    // Arcs from s up to the meeting vertex, then down to t
+    std::vector<std::pair<int, bool>> route;
+    for (int v = meet; fwd.path[v] != -1; v = lower[fwd.path[v]])
+        route.emplace_back(fwd.path[v], true);
+    std::reverse(route.begin(), route.end());
+    for (int v = meet; bwd.path[v] != -1; v = lower[bwd.path[v]])
+        route.emplace_back(bwd.path[v], false);
+    for (auto [a, upwards] : route)
+        unpack(metric, a, upwards, edges);
+    return best;
+}
+
+void CustomizableHierarchy::unpack(const HierarchyMetric &metric, const int arc, const bool upwards, std::vector<int> &edges) const {
+    std::vector<std::pair<int, bool>> stack = {{arc, upwards}};
+    while (!stack.empty()) {
+        auto [a, up] = stack.back();
+        stack.pop_back();
+        const int via = up ? metric.upVia[a] : metric.downVia[a];
+        if (via == -1) {
+            edges.push_back(up ? metric.upEdge[a] : metric.downEdge[a]);
+            continue;
+        }
+        // lower -> via -> upper (upwards) or upper -> via -> lower (downwards); via is below both ends
+        const int toLower = findArc(via, lower[a]), toUpper = findArc(via, upper[a]);
+        if (up) {
+            stack.emplace_back(toUpper, true);
+            stack.emplace_back(toLower, false);
+        } else {
+            stack.emplace_back(toLower, true);
+            stack.emplace_back(toUpper, false);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef CUSTOMIZABLEHIERARCHY_H
+#define CUSTOMIZABLEHIERARCHY_H
+
+#include <vector>
+#include "CSRGraph.h"
+#include "AvoidMask.h"
+#include "HierarchyMetric.h"
+#include "SearchContext.h"
+
+/**
+ * @brief Customizable Contraction Hierarchy (CCH) over the driving times of a graph.
+ *
+ * @details Unlike ContractionHierarchy, the order and the arcs depend only on which vertices are joined by a
+ * drivable edge, not on the times: vertices are eliminated by minimum degree and every pair of neighbours left when
+ * a vertex is eliminated becomes an arc. The times are then added by a customization that goes through the
+ * vertices in order and relaxes every lower triangle, so any metric (in particular the driving times with some
+ * edges or vertices avoided) costs one customization instead of a new contraction.
+ * For a query with restrictions only the arcs that depend on an avoided edge or vertex are customized again,
+ * starting from the metric without restrictions, which is much cheaper than a full customization when few
+ * elements are avoided.
+ * An avoided vertex can be left but not entered, as in dijkstra(...), so it still works as an origin.
+ */
+class CustomizableHierarchy {
+public:
+    /**
+     * @brief Computes the order and the arcs, and customizes the metric without restrictions.
+     *
+     * @param csr The graph; its drivable edges give the arcs and its driving times the base metric.
+     *
+     * @note Time Complexity: O(V * d^2) for the elimination and the customization, d being the number of
+     * neighbours of a vertex when it is eliminated.
+     */
+    void build(const CSRGraph &csr);
+
+    /**
+     * @brief Checks if the hierarchy was built.
+     *
+     * @return True if build(...) was called for a graph with at least one vertex.
+     */
+    bool isBuilt() const { return !rank.empty(); }
+
+    /**
+     * @brief Gets the metric without restrictions.
+     *
+     * @return The customized driving times.
+     */
+    const HierarchyMetric &baseMetric() const { return base; }
+
+    /**
+     * @brief Customizes the metric for a set of restrictions.
+     *
+     * @details Starts from the metric without restrictions and only recomputes, in order, the arcs whose weight
+     * depends on an avoided edge or vertex.
+     *
+     * @param csr The graph the hierarchy was built for.
+     * @param metric Where the metric is stored.
+     * @param avoidNode Vertices that cannot be entered.
+     * @param avoidEdge Edges that cannot be used.
+     *
+     * @note Time Complexity: O(A) to copy the base metric, plus O(d) for each arc recomputed.
+     */
+    void customize(const CSRGraph &csr, HierarchyMetric &metric, const AvoidMask &avoidNode, const AvoidMask &avoidEdge) const;
+
+    /**
+     * @brief Finds the fastest driving route between two vertices for a metric.
+     *
+     * @param ctx Search state (the driving and backward layers and the queue positions are used).
+     * @param metric A metric of this hierarchy.
+     * @param s The dense index of the origin.
+     * @param t The dense index of the destination.
+     * @param edges Where the CSR ids of the edges of the route are stored, in order (empty if there is no route).
+     * @return The driving time of the route, or INF if there is none.
+     *
+     * @note Time Complexity: O((V'+A')logV') where V' and A' are the vertices and arcs above s and t.
+     */
+    double query(SearchContext &ctx, const HierarchyMetric &metric, int s, int t, std::vector<int> &edges) const;
+
+    /**
+     * @brief Gets the number of arcs.
+     *
+     * @return The number of arcs.
+     */
+    int numArcs() const { return static_cast<int>(lower.size()); }
+
+private:
+    /**
+     * @brief Finds the arc between two vertices.
+     *
+     * @return The arc id, or -1 if they are not joined.
+     */
+    int findArc(int u, int v) const;
+
+    /**
+     * @brief Computes the weights of an arc from its original edges and its lower triangles.
+     *
+     * @return True if a weight changed.
+     */
+    bool recompute(const CSRGraph &csr, HierarchyMetric &metric, int a, const AvoidMask *avoidNode,
+                   const AvoidMask *avoidEdge) const;
+
+    /**
+     * @brief Appends the original edges of an arc, in one direction, to a route.
+     */
+    void unpack(const HierarchyMetric &metric, int arc, bool upwards, std::vector<int> &edges) const;
+
+    std::vector<int> rank;            ///< Elimination order of each vertex.
+    std::vector<int> lower;           ///< Lower ranked end of each arc.
+    std::vector<int> upper;           ///< Higher ranked end of each arc.
+    std::vector<int> upOffsets;       ///< upOffsets[u]..upOffsets[u+1] are the arcs to higher ranked vertices.
+    std::vector<int> upNeighbours;    ///< Higher ranked end of those arcs, sorted by vertex.
+    std::vector<int> upArcs;          ///< Their arc ids.
+    std::vector<int> downOffsets;     ///< downOffsets[u]..downOffsets[u+1] are the arcs to lower ranked vertices.
+    std::vector<int> downNeighbours;  ///< Lower ranked end of those arcs, sorted by vertex.
+    std::vector<int> downArcs;        ///< Their arc ids.
+    HierarchyMetric base;             ///< Metric without restrictions.
+};
+
+#endif //CUSTOMIZABLEHIERARCHY_H
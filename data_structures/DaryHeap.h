@@ -0,0 +1,82 @@
+/*
+ * DaryHeap.h
+ * Mutable 4-ary min-heap over dense vertex indices, keyed by an external distance array.
+ * Same interface as IndexedPriorityQueue, but each slot keeps a copy of the key next to the index, so
+ * sifting compares contiguous pairs instead of looking every key up in the distance array.
+ */
+
+#ifndef DA_TP_CLASSES_DARYHEAP
+#define DA_TP_CLASSES_DARYHEAP
+
+#include <utility>
+#include <vector>
+
+/**
+ * key[i] is the priority of index i and pos[i] is where the queue keeps its position in the heap
+ * (pos must have one entry per index that can be inserted).
+ */
+class DaryHeap {
+    static constexpr unsigned D = 4; // 4 children: a node's children share a cache line
+    std::vector<std::pair<double, int>> H; // (key, index)
+    const std::vector<double> &key;
+    std::vector<int> &pos;
+    void heapifyUp(unsigned i, std::pair<double, int> x);
+    void heapifyDown(unsigned i, std::pair<double, int> x);
+    void set(unsigned i, std::pair<double, int> x) { H[i] = x; pos[x.second] = static_cast<int>(i); }
+
+public:
+    DaryHeap(const std::vector<double> &key, std::vector<int> &pos);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    bool empty() const { return H.empty(); }
+};
+
+inline DaryHeap::DaryHeap(const std::vector<double> &key, std::vector<int> &pos)
+    : key(key), pos(pos) { }
+
+inline int DaryHeap::extractMin() {
+    int x = H[0].second;
+    std::pair<double, int> last = H.back();
+    H.pop_back();
+    if (!H.empty()) heapifyDown(0, last);
+    pos[x] = 0;
+    return x;
+}
+
+inline void DaryHeap::insert(int x) {
+    H.emplace_back();
+    heapifyUp(H.size() - 1, {key[x], x});
+}
+
+inline void DaryHeap::decreaseKey(int x) {
+    heapifyUp(pos[x], {key[x], x});
+}
+
+inline void DaryHeap::heapifyUp(unsigned i, std::pair<double, int> x) {
+    while (i > 0 && x.first < H[(i - 1) / D].first) {
+        set(i, H[(i - 1) / D]);
+        i = (i - 1) / D;
+    }
+    set(i, x);
+}
+
+inline void DaryHeap::heapifyDown(unsigned i, std::pair<double, int> x) {
+    const unsigned n = H.size();
+    while (true) {
+        unsigned first = i * D + 1;
+        if (first >= n)
+            break;
+        unsigned k = first; // smallest child of i
+        for (unsigned c = first + 1; c < first + D && c < n; c++)
+            if (H[c].first < H[k].first)
+                k = c;
+        if (!(H[k].first < x.first))
+            break;
+        set(i, H[k]);
+        i = k;
+    }
+    set(i, x);
+}
+
+#endif /* DA_TP_CLASSES_DARYHEAP */
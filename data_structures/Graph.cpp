@@ -1,8 +1,14 @@
 #include "Graph.h"
-#include <fstream>
-#include <sstream>
+#include "CsvReader.h"
 #include <iostream>
 #include <cstdlib>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "IndexedPriorityQueue.h"
 
 /************************* Vertex  **************************/
 
@@ -10,7 +16,7 @@ Vertex::Vertex(const std::string &name, const int &id, const std::string &code,
     : name(name), id(id), code(code), park(park) { }
 
 Edge* Vertex::addEdge(Vertex *d, double walk, double drive) {
-    auto newEdge = new Edge(this, d, walk, drive);
+    auto newEdge = edgePool ? edgePool->create(this, d, walk, drive) : new Edge(this, d, walk, drive);
     adj.push_back(newEdge);
     d->incoming.push_back(newEdge);
     return newEdge;
@@ -43,10 +49,6 @@ void Vertex::removeOutgoingEdges() {
     }
 }
 
-bool Vertex::operator<(const Vertex &vertex) const {
-    return this->getDist() < vertex.getDist();
-}
-
 std::string Vertex::getName() const {
     return this->name;
 }
@@ -55,6 +57,10 @@ int Vertex::getId() const {
     return this->id;
 }
 
+int Vertex::getIndex() const {
+    return this->index;
+}
+
 std::string Vertex::getCode() const {
     return this->code;
 }
@@ -64,79 +70,19 @@ bool Vertex::isPark() const {
 }
 
 
-std::vector<Edge*> Vertex::getAdj() const {
+std::span<Edge *const> Vertex::getAdj() const {
     return this->adj;
 }
-bool Vertex::isVisited() const {
-    return this->visited;
-}
-
-double Vertex::getDist(const int mode) const {
-    switch (mode) {
-        case -1:
-            return this->dist;
-        case 0:
-            return this->driveDist;
-        case 1:
-            return this->walkDist;
-        default:
-            return INF;
-    }
-}
 
-Edge *Vertex::getPath(int mode) const {
-    switch (mode) {
-        case 0:
-            return this->drivePath;
-        case 1:
-            return this->walkPath;
-        default:
-            return nullptr;
-    }
-}
-
-std::vector<Edge *> Vertex::getIncoming() const {
+std::span<Edge *const> Vertex::getIncoming() const {
     return this->incoming;
 }
 
-bool Vertex::isAvoiding() const{
-    return this->avoid;
-}
-
 void Vertex::setName(const std::string& newName) {this->name = newName;}
 void Vertex::setId(const int& newId) {this->id = newId;}
+void Vertex::setIndex(const int newIndex) {this->index = newIndex;}
 void Vertex::setCode(const std::string& newCode) {this->code = newCode;}
 void Vertex::setPark(const bool newPark) {this->park = newPark;}
-void Vertex::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-void Vertex::setAvoiding(bool avoid) {
-    this->avoid = avoid;
-}
-
-void Vertex::setDist(const double dist, const int mode) {
-    switch (mode) {
-        case 0:
-            this->driveDist = dist;
-            break;
-        case 1:
-            this->walkDist = dist;
-            break;
-    }
-    this->dist = dist;
-}
-
-void Vertex::setPath(Edge *path, int mode) {
-    switch (mode) {
-        case 0:
-            this->drivePath = path;
-        break;
-        case 1:
-            this->walkPath = path;
-        break;
-    }
-}
 
 void Vertex::deleteEdge(const Edge *edge) const {
     Vertex *dest = edge->getDest();
@@ -150,7 +96,10 @@ void Vertex::deleteEdge(const Edge *edge) const {
             ++it;
         }
     }
-    delete edge;
+    if (edgePool)
+        edgePool->destroy(const_cast<Edge *>(edge));
+    else
+        delete edge;
 }
 
 
@@ -173,14 +122,6 @@ Edge *Edge::getReverse() const {
 void Edge::setReverse(Edge *reverse) {
     this->reverse = reverse;
 }
-bool Edge::isAvoiding() const {
-    return this->avoid;
-}
-
-void Edge::setAvoiding(bool avoid) {
-    this->avoid = avoid;
-}
-
 
 void Edge::setWalk(const double walk) { this->walk = walk; }
 double Edge::getWalk() const { return this->walk; }
@@ -200,17 +141,7 @@ void Edge::setTime(const double time, const int mode) {
     }
 }
 double Edge::getTime(const int mode) const {
-    switch (mode) {
-        case 0:
-            return this->drive;
-        break;
-        case 1:
-            return this->walk;
-        break;
-        default:
-            std::cout<<"Mode not found"<<std::endl;
-        return -1;
-    }
+    return mode == DRIVING ? this->drive : mode == WALKING ? this->walk : -1;
 }
 
 /********************** Graph  ****************************/
@@ -219,24 +150,58 @@ int Graph::getNumVertex() const {
     return vertexSet.size();
 }
 
-std::vector<Vertex *> Graph::getVertexSet() const {
+std::span<Vertex *const> Graph::getVertexSet() const {
     return vertexSet;
 }
 
+void Graph::buildCSR() {
+    clearMatrices();
+    csr.build(vertexSet);
+}
+
+const CSRGraph &Graph::getCSR() const {
+    return csr;
+}
+
+
+void Graph::setEdges(CSRGraph &&newCsr, std::span<const int> reverse) {
+    clearMatrices();
+    csr = std::move(newCsr);
+    std::vector<Edge *> edges(csr.numEdges());
+    for (auto v : vertexSet) {
+        const int u = v->getIndex();
+        v->adj.reserve(csr.end(u) - csr.begin(u));
+        for (int e : csr.edges(u)) {
+            Edge *edge = edgePool->create(v, vertexSet[csr.target(e)], csr.walk(e), csr.drive(e));
+            v->adj.push_back(edge);
+            edges[e] = edge;
+        }
+    }
+    for (auto v : vertexSet) {
+        const std::span<const int> in = csr.incoming(v->getIndex());
+        v->incoming.reserve(in.size());
+        for (int e : in)
+            v->incoming.push_back(edges[e]);
+    }
+    for (int e = 0; e < csr.numEdges(); e++)
+        if (reverse[e] >= 0) edges[e]->setReverse(edges[reverse[e]]);
+}
+
 // Finds a vertex by its code (assumed to be unique).
-Vertex *Graph::findVertex(const std::string &code) const {
-    for (auto v : vertexSet)
-        if (v->getCode() == code)
-            return v;
-    return nullptr;
+Vertex *Graph::findVertex(std::string_view code) const {
+    auto it = codeIndex.find(code);
+    return it == codeIndex.end() ? nullptr : vertexSet[it->second];
 }
 
 // Finds a vertex by its id.
 Vertex *Graph::findVertex(const int &id) const {
-    for (auto v : vertexSet)
-        if (v->getId() == id)
-            return v;
-    return nullptr;
+    auto it = idIndex.find(id);
+    return it == idIndex.end() ? nullptr : vertexSet[it->second];
+}
+
+int Graph::findVertexIndex(const int &id) const {
+    auto it = idIndex.find(id);
+    return it == idIndex.end() ? -1 : it->second;
 }
 
 int Graph::findVertexIdx(const std::string &name) const {
@@ -246,12 +211,32 @@ int Graph::findVertexIdx(const std::string &name) const {
     return -1;
 }
 
+void Graph::rebuildIndex() {
+    idIndex.clear();
+    codeIndex.clear();
+    for (unsigned i = 0; i < vertexSet.size(); i++) {
+        vertexSet[i]->setIndex(static_cast<int>(i));
+        idIndex.emplace(vertexSet[i]->getId(), i);
+        codeIndex.emplace(vertexSet[i]->getCode(), i);
+    }
+}
+
 // Adds a vertex with the given properties.
 // Returns false if a vertex with the same code already exists.
 bool Graph::addVertex(const std::string &name, const int &id, const std::string &code, const bool &park) {
-    if (findVertex(code) != nullptr)
+    const int index = static_cast<int>(vertexSet.size());
+    if (!codeIndex.emplace(code, index).second)
         return false;
-    vertexSet.push_back(new Vertex(name, id, code, park));
+    clearMatrices();
+    idIndex.emplace(id, index); // the first vertex with a given id wins, as with a linear search
+    if (!vertexPool) {
+        vertexPool = std::make_unique<ObjectPool<Vertex>>();
+        edgePool = std::make_unique<ObjectPool<Edge>>();
+    }
+    auto v = vertexPool->create(name, id, code, park);
+    v->edgePool = edgePool.get();
+    v->setIndex(index);
+    vertexSet.push_back(v);
     return true;
 }
 
@@ -259,6 +244,7 @@ bool Graph::addVertex(const std::string &name, const int &id, const std::string
 bool Graph::removeVertex(const std::string &name) {
     for (auto it = vertexSet.begin(); it != vertexSet.end(); ++it) {
         if ((*it)->getName() == name) {
+            clearMatrices();
             Vertex *v = *it;
             v->removeOutgoingEdges();
             // Remove edges in other vertices that point to v.
@@ -266,7 +252,8 @@ bool Graph::removeVertex(const std::string &name) {
                 u->removeEdge(v->getName());
             }
             vertexSet.erase(it);
-            delete v;
+            vertexPool->destroy(v);
+            rebuildIndex();
             return true;
         }
     }
@@ -275,7 +262,7 @@ bool Graph::removeVertex(const std::string &name) {
 
 // Adds an edge between vertices identified by their names.
 // The parameters are: source name, destination name, walk weight, drive weight.
-bool Graph::addEdge(const std::string &sourceName, const std::string &destName, double walk, double drive) const {
+bool Graph::addEdge(std::string_view sourceName, std::string_view destName, double walk, double drive) const {
     auto v1 = findVertex(sourceName);
     auto v2 = findVertex(destName);
     if (v1 == nullptr || v2 == nullptr)
@@ -292,7 +279,7 @@ bool Graph::removeEdge(const std::string &sourceName, const std::string &destNam
     return srcVertex->removeEdge(destName);
 }
 
-bool Graph::addBidirectionalEdge(const std::string &sourceName, const std::string &destName, double walk, double drive) const {
+bool Graph::addBidirectionalEdge(std::string_view sourceName, std::string_view destName, double walk, double drive) const {
     auto v1 = findVertex(sourceName);
     auto v2 = findVertex(destName);
     if (v1 == nullptr || v2 == nullptr)
@@ -324,66 +311,441 @@ inline void deleteMatrix(double **m, int n) {
 }
 
 Graph::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    clear();
+}
+
+Graph::Graph(Graph &&other) noexcept {
+    *this = std::move(other);
+}
+
+Graph &Graph::operator=(Graph &&other) noexcept {
+    if (this != &other) {
+        clear();
+        vertexSet = std::move(other.vertexSet);
+        idIndex = std::move(other.idIndex);
+        codeIndex = std::move(other.codeIndex);
+        csr = std::move(other.csr);
+        vertexPool = std::move(other.vertexPool);
+        edgePool = std::move(other.edgePool);
+        for (int mode = 0; mode < 2; mode++) {
+            distMatrix[mode] = std::exchange(other.distMatrix[mode], nullptr);
+            pathMatrix[mode] = std::exchange(other.pathMatrix[mode], nullptr);
+        }
+        matrixSize = std::exchange(other.matrixSize, 0);
+        other.vertexSet.clear();
+        other.idIndex.clear();
+        other.codeIndex.clear();
+        other.csr = CSRGraph();
+    }
+    return *this;
+}
+
+void Graph::clearMatrices() {
+    for (int mode = 0; mode < 2; mode++) {
+        deleteMatrix(distMatrix[mode], matrixSize);
+        deleteMatrix(pathMatrix[mode], matrixSize);
+        distMatrix[mode] = nullptr;
+        pathMatrix[mode] = nullptr;
+    }
+    matrixSize = 0;
+}
+
+void Graph::clear() {
+    clearMatrices();
+
+    // Edges need no destructor call: their slabs are simply freed with the arena.
+    static_assert(std::is_trivially_destructible_v<Edge>);
+    for (auto v : vertexSet)
+        std::destroy_at(v);
+    vertexSet.clear();
+    idIndex.clear();
+    codeIndex.clear();
+    csr = CSRGraph();
+    vertexPool.reset();
+    edgePool.reset();
+}
+
+namespace {
+
+// An edge row of the distances file, resolved to dense indices.
+struct DistanceRow {
+    int a, b;
+    double drive, walk;
+};
+
+// What one thread extracts from its chunk of the distances file.
+struct DistanceChunk {
+    std::string_view text;            // the bytes of the chunk
+    std::size_t start = 0;            // offset of the chunk in the file
+    std::vector<DistanceRow> rows;    // valid rows, in file order
+    int failedRows = 0;               // rows whose locations are not in the graph
+    std::vector<int> outCount;        // edges per origin
+    std::vector<int> inCount;         // edges per destination
+    int errorLine = 0;                // line (inside the chunk) of the first malformed row, 0 if none
+};
+
+void parseDistanceChunk(const Graph &g, DistanceChunk &chunk) {
+    const int n = g.getNumVertex();
+    chunk.outCount.assign(n, 0);
+    chunk.inCount.assign(n, 0);
+
+    CsvReader reader(chunk.text);
+    std::string_view fields[4];
+    std::string scratch1, scratch2;
+    int count;
+    while ((count = reader.nextRecord(fields, 4)) != -1) {
+        if (count < 4)
+            continue;
+        double drive, walk;
+        //driving might not be available ("X")
+        bool valid = (fields[2] == "X") ? (drive = -1, true) : parseDouble(fields[2], drive);
+        if (!valid || !parseDouble(fields[3], walk)) {
+            chunk.errorLine = reader.getLine();
+            return;
+        }
+
+        // Codes with escaped quotes are the only ones that need a copy
+        std::string_view loc1 = fields[0], loc2 = fields[1];
+        if (loc1.find('"') != std::string_view::npos) loc1 = scratch1 = CsvReader::unquote(loc1);
+        if (loc2.find('"') != std::string_view::npos) loc2 = scratch2 = CsvReader::unquote(loc2);
+
+        const Vertex *v1 = g.findVertex(loc1);
+        const Vertex *v2 = g.findVertex(loc2);
+        if (v1 == nullptr || v2 == nullptr) {
+            chunk.failedRows++;
+            continue;
+        }
+        const int a = v1->getIndex(), b = v2->getIndex();
+        chunk.rows.push_back({a, b, drive, walk});
+        chunk.outCount[a]++;
+        chunk.outCount[b]++;
+        chunk.inCount[b]++;
+        chunk.inCount[a]++;
+    }
 }
 
-Graph initialize(const std::string &locs, const std::string &dists) {
+// Runs fn(0..tasks-1), each on its own thread (the last one on the calling thread).
+template <class F>
+void parallelFor(unsigned tasks, F fn) {
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t + 1 < tasks; t++)
+        threads.emplace_back(fn, t);
+    if (tasks > 0)
+        fn(tasks - 1);
+    for (auto &th : threads)
+        th.join();
+}
+
+// Turns per-chunk counts into the first slot of each (chunk, vertex) pair: chunks are laid out in file order
+// inside the range of each vertex. Returns the offsets of the vertices. Vertex ranges are split among threads.
+std::vector<int> chunkOffsets(std::vector<DistanceChunk> &chunks, std::vector<int> DistanceChunk::*count, int n) {
+    std::vector<int> offsets(n + 1, 0);
+    const auto tasks = static_cast<unsigned>(chunks.size());
+    parallelFor(tasks, [&](unsigned t) {
+        for (int u = static_cast<int>(n * uint64_t(t) / tasks); u < static_cast<int>(n * uint64_t(t + 1) / tasks); u++) {
+            int total = 0;
+            for (auto &c : chunks) {
+                int k = (c.*count)[u];
+                (c.*count)[u] = total; // position of the chunk's first edge, relative to the vertex
+                total += k;
+            }
+            offsets[u + 1] = total;
+        }
+    });
+    for (int u = 0; u < n; u++)
+        offsets[u + 1] += offsets[u];
+    return offsets;
+}
+
+}
+
+Graph initialize(const std::string &locs, const std::string &dists, unsigned threads) {
     Graph g;
-    std::string line;
 
-    std::ifstream locFile(locs);
-    std::ifstream distFile(dists);
+    // Both files are memory-mapped and parsed in place: fields are views into the mapping and numbers
+    // are read with std::from_chars, so only the names and codes kept by the vertices are allocated.
+    MappedFile locFile(locs);
+    MappedFile distFile(dists);
 
-    if (!locFile.is_open() && !distFile.is_open()) {
+    if (!locFile.isOpen() && !distFile.isOpen()) {
         throw std::runtime_error("Could not open files: " + locs + " and " + dists);
     }
-    if (!locFile.is_open()) {
+    if (!locFile.isOpen()) {
         throw std::runtime_error("Failed to open locations file: " + locs);
     }
-    if (!distFile.is_open()) {
+    if (!distFile.isOpen()) {
         throw std::runtime_error("Failed to open distances file: " + dists);
     }
 
-    std::getline(locFile, line); // Skip header line
-    while (std::getline(locFile, line)) {
-        if (line.empty())
+    std::string_view fields[4];
+
+    CsvReader locReader(locFile.view());
+    locReader.nextRecord(fields, 4); // Skip header line
+    int count;
+    while ((count = locReader.nextRecord(fields, 4)) != -1) {
+        if (count < 4)
             continue;
-        std::stringstream ss(line);
-        std::string nameStr, idStr, codeStr, parkStr;
-        if (std::getline(ss, nameStr, ',') && std::getline(ss, idStr, ',') &&
-            std::getline(ss, codeStr, ',') && std::getline(ss, parkStr, ',')) {
-            int id = std::stoi(idStr);
-            bool park = (std::stoi(parkStr) != 0);
-            if (g.addVertex(nameStr, id, codeStr, park) == false) {
-                std::cout<<"Problem adding vertex "<<nameStr<<std::endl;
+        int id, park;
+        if (!parseInt(fields[1], id) || !parseInt(fields[3], park)) {
+            throw std::runtime_error("Invalid location at line " + std::to_string(locReader.getLine()) + " of " + locs);
+        }
+        if (g.addVertex(CsvReader::unquote(fields[0]), id, CsvReader::unquote(fields[2]), park != 0) == false) {
+            std::cout<<"Problem adding vertex "<<fields[0]<<std::endl;
+        }
+    }
+    const int n = g.getNumVertex();
+
+    // Split the distances (after the header) into chunks that end at line breaks
+    const std::string_view text = distFile.view();
+    CsvReader headerReader(text);
+    headerReader.nextRecord(fields, 4); // Skip header line
+    const std::size_t bodyStart = headerReader.getPosition();
+    const std::string_view body = text.substr(bodyStart);
+
+    constexpr std::size_t MIN_CHUNK_BYTES = 64 * 1024;
+    unsigned chunkCount = threads;
+    if (chunkCount == 0) {
+        chunkCount = std::max(1u, std::thread::hardware_concurrency());
+        chunkCount = static_cast<unsigned>(std::min<std::size_t>(chunkCount, body.size() / MIN_CHUNK_BYTES + 1));
+    }
+    if (body.find('"') != std::string_view::npos)
+        chunkCount = 1;
+
+    std::vector<DistanceChunk> chunks(chunkCount);
+    std::size_t begin = 0;
+    for (unsigned t = 0; t < chunkCount; t++) {
+        std::size_t end = body.size() * (t + 1) / chunkCount;
+        if (t + 1 < chunkCount) {
+            end = std::max(end, begin);
+            std::size_t nl = body.find('\n', end == 0 ? 0 : end - 1);
+            end = nl == std::string_view::npos ? body.size() : nl + 1;
+        }
+        chunks[t].text = body.substr(begin, end - begin);
+        chunks[t].start = bodyStart + begin;
+        begin = end;
+    }
+
+    // 1. Parse every chunk
+    parallelFor(chunkCount, [&](unsigned t) { parseDistanceChunk(g, chunks[t]); });
+    for (const auto &c : chunks) {
+        if (c.errorLine != 0) {
+            const auto line = std::count(text.begin(), text.begin() + static_cast<long>(c.start), '\n') + c.errorLine;
+            throw std::runtime_error("Invalid distance at line " + std::to_string(line) + " of " + dists);
+        }
+    }
+    for (const auto &c : chunks) {
+        for (int i = 0; i < 2 * c.failedRows; i++) { // one message per direction, as with addEdge
+            std::cout<<"Problem adding Edge"<<std::endl;
+        }
+    }
+
+    // 2. Counting sort: every row gives the edges a->b and b->a, in that order. Within each vertex, the
+    // chunks are laid out in file order, so edges keep the order in which a serial load would add them.
+    std::vector<int> offsets = chunkOffsets(chunks, &DistanceChunk::outCount, n);
+    std::vector<int> inOffsets = chunkOffsets(chunks, &DistanceChunk::inCount, n);
+    const int m = offsets[n];
+    std::vector<int> sources(m), targets(m), inEdges(m), reverse(m);
+    std::vector<double> driveTimes(m), walkTimes(m);
+
+    // 3. Scatter the edges of each chunk into their slots
+    parallelFor(chunkCount, [&](unsigned t) {
+        DistanceChunk &c = chunks[t];
+        auto place = [&](int from, int to, const DistanceRow &r) {
+            const int e = offsets[from] + c.outCount[from]++;
+            sources[e] = from;
+            targets[e] = to;
+            driveTimes[e] = r.drive;
+            walkTimes[e] = r.walk;
+            inEdges[inOffsets[to] + c.inCount[to]++] = e;
+            return e;
+        };
+        for (const DistanceRow &r : c.rows) {
+            const int e1 = place(r.a, r.b, r);
+            const int e2 = place(r.b, r.a, r);
+            reverse[e1] = e2;
+            reverse[e2] = e1;
+        }
+    });
+
+    // 4. The slots of each destination follow the file; the CSR lists them by increasing edge id, as buildCSR() does
+    parallelFor(chunkCount, [&](unsigned t) {
+        for (int u = static_cast<int>(n * uint64_t(t) / chunkCount); u < static_cast<int>(n * uint64_t(t + 1) / chunkCount); u++)
+            std::sort(inEdges.begin() + inOffsets[u], inEdges.begin() + inOffsets[u + 1]);
+    });
+
+    CSRGraph csr;
+    csr.build(g.getVertexSet(), std::move(offsets), std::move(sources), std::move(targets),
+              std::move(driveTimes), std::move(walkTimes), std::move(inOffsets), std::move(inEdges));
+    g.setEdges(std::move(csr), reverse);
+    return g;
+}
+
+/********************** All-pairs matrices  ****************************/
+
+namespace {
+
+// Side of the square tiles of the blocked Floyd-Warshall: a tile of distances and one of paths fit in L1/L2
+constexpr int MATRIX_TILE = 64;
+
+// Auto uses Floyd-Warshall when V^2 <= FLOYD_WARSHALL_DENSITY * E * log2(V), i.e. when its V^3 steps cost less
+// than the V heap-based Dijkstras. The break-even is about 7 with scalar code and about 20 with AVX2.
+constexpr double FLOYD_WARSHALL_DENSITY = 8;
+
+// n rows of the given number of columns (at least n); nothing is left allocated if one of them throws
+template <class T>
+T **newMatrix(int n, int columns) {
+    T **m = new T *[n]();
+    try {
+        for (int i = 0; i < n; i++)
+            m[i] = new T[columns];
+    } catch (...) {
+        deleteMatrix(m, n);
+        throw;
+    }
+    return m;
+}
+
+// One row of each matrix: the same search as dijkstra() with the binary heap, without restrictions, so it
+// settles the vertices (and breaks ties) in the same order
+void matrixRow(const CSRGraph &csr, int mode, int s, std::vector<double> &dist, std::vector<int> &path,
+               std::vector<int> &pos, double *distRow, int *pathRow) {
+    std::fill(dist.begin(), dist.end(), INF);
+    std::fill(path.begin(), path.end(), -1);
+    dist[s] = 0;
+    IndexedPriorityQueue q(dist, pos);
+    q.insert(s);
+    while (!q.empty()) {
+        const int v = q.extractMin();
+        for (int e : csr.edges(v)) {
+            const double t = csr.time(e, mode);
+            if (t == -1) continue;
+            const int w = csr.target(e);
+            const double oldDist = dist[w];
+            if (oldDist > dist[v] + t) {
+                dist[w] = dist[v] + t;
+                path[w] = e;
+                if (oldDist == INF) q.insert(w);
+                else q.decreaseKey(w);
             }
         }
     }
-    locFile.close();
+    std::copy(dist.begin(), dist.end(), distRow);
+    std::copy(path.begin(), path.end(), pathRow);
+}
+
+// d[i][jb..jb+MATRIX_TILE) through k: fixed length, no aliasing and no branch, so it is vectorized
+[[gnu::noinline]] void relaxRow(double *__restrict di, int *__restrict pi, const double *__restrict dk, const int *__restrict pk,
+              const double dik) {
+    for (int j = 0; j < MATRIX_TILE; j++) {
+        const double via = dik + dk[j], old = di[j];
+        const bool shorter = via < old;
+        di[j] = shorter ? via : old;
+        pi[j] = shorter ? pk[j] : pi[j];
+    }
+}
 
-    std::getline(distFile, line); // Skip header line
-    while (std::getline(distFile, line)) {
-        if (line.empty())
-            continue;
-        std::stringstream ss(line);
-        std::string loc1Str, loc2Str, driveStr, walkStr;
-        if (std::getline(ss, loc1Str, ',') &&
-            std::getline(ss, loc2Str, ',') &&
-            std::getline(ss, driveStr, ',') &&
-            std::getline(ss, walkStr, ',')) {
-            double drive = (driveStr == "X") ? -1 : std::stod(driveStr); //driving might not be available ("X")
-            double walk = std::stod(walkStr);
-
-            if (g.addEdge(loc1Str, loc2Str, walk, drive) == 0) {
-                std::cout<<"Problem adding Edge"<<std::endl;
+// Relaxes the tile of rows [ib, ib+MATRIX_TILE) and columns [jb, jb+MATRIX_TILE) through the vertices of the
+// block starting at kb. Rows are padded to whole tiles, and row k is skipped since d[k][k] = 0 leaves it unchanged.
+void relaxTile(double **d, int **p, int n, int ib, int jb, int kb) {
+    const int iEnd = std::min(ib + MATRIX_TILE, n);
+    const int kEnd = std::min(kb + MATRIX_TILE, n);
+    for (int k = kb; k < kEnd; k++) {
+        for (int i = ib; i < iEnd; i++) {
+            const double dik = d[i][k];
+            if (i != k && dik != INF) relaxRow(d[i] + jb, p[i] + jb, d[k] + jb, p[k] + jb, dik);
+        }
+    }
+}
+
+// Blocked Floyd-Warshall: for each block of intermediate vertices, its diagonal tile first, then the tiles in its
+// row and column, which only depend on the diagonal one, and then every other tile, which only depends on those
+void floydWarshall(const CSRGraph &csr, int mode, double **d, int **p, int columns, unsigned tasks) {
+    const int n = csr.numVertices();
+    parallelFor(tasks, [&](unsigned t) {
+        for (int u = static_cast<int>(t); u < n; u += static_cast<int>(tasks)) {
+            std::fill(d[u], d[u] + columns, INF);
+            std::fill(p[u], p[u] + columns, -1);
+            d[u][u] = 0;
+            for (int e : csr.edges(u)) {
+                const double w = csr.time(e, mode);
+                if (w != -1 && w < d[u][csr.target(e)]) {
+                    d[u][csr.target(e)] = w;
+                    p[u][csr.target(e)] = e;
+                }
+            }
+        }
+    });
+
+    const int blocks = (n + MATRIX_TILE - 1) / MATRIX_TILE;
+    for (int kb = 0; kb < blocks; kb++) {
+        const int k = kb * MATRIX_TILE;
+        relaxTile(d, p, n, k, k, k);
+        parallelFor(tasks, [&](unsigned t) {
+            for (int b = static_cast<int>(t); b < blocks; b += static_cast<int>(tasks)) {
+                if (b == kb) continue;
+                relaxTile(d, p, n, k, b * MATRIX_TILE, k);
+                relaxTile(d, p, n, b * MATRIX_TILE, k, k);
             }
-            if (g.addEdge(loc2Str, loc1Str, walk, drive) == 0) {
-                std::cout<<"Problem adding Edge"<<std::endl;
+        });
+        parallelFor(tasks, [&](unsigned t) {
+            for (int ib = static_cast<int>(t); ib < blocks; ib += static_cast<int>(tasks)) {
+                if (ib == kb) continue;
+                for (int jb = 0; jb < blocks; jb++)
+                    if (jb != kb) relaxTile(d, p, n, ib * MATRIX_TILE, jb * MATRIX_TILE, k);
+            }
+        });
+    }
+}
+
+}
+
+void Graph::computeMatrices(MatrixMethod method, unsigned threads) {
+    clearMatrices();
+    const int n = csr.numVertices();
+    const unsigned tasks = std::min<unsigned>(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads,
+                                              std::max(n, 1));
+    if (method == MatrixMethod::Auto) {
+        const double v = n, e = csr.numEdges();
+        method = v * v <= FLOYD_WARSHALL_DENSITY * e * std::log2(std::max(v, 2.0))
+                     ? MatrixMethod::FloydWarshall : MatrixMethod::Dijkstra;
+    }
+
+    // Floyd-Warshall works on whole tiles, so its rows are padded with unreachable columns
+    const int columns = method == MatrixMethod::FloydWarshall ? (n + MATRIX_TILE - 1) / MATRIX_TILE * MATRIX_TILE : n;
+
+    // Each matrix is kept as soon as it is allocated, with its size, so that clearMatrices() frees every one of
+    // them if a later allocation throws (e.g. bad_alloc on a large graph)
+    matrixSize = n;
+    try {
+        for (int mode = 0; mode < 2; mode++) {
+            double **d = distMatrix[mode] = newMatrix<double>(n, columns);
+            int **p = pathMatrix[mode] = newMatrix<int>(n, columns);
+            if (method == MatrixMethod::FloydWarshall) {
+                floydWarshall(csr, mode, d, p, columns, tasks);
+            } else {
+                std::atomic<int> next{0};
+                parallelFor(tasks, [&](unsigned) {
+                    std::vector<double> dist(n);
+                    std::vector<int> path(n), pos(n);
+                    for (int s = next++; s < n; s = next++)
+                        matrixRow(csr, mode, s, dist, path, pos, d[s], p[s]);
+                });
             }
         }
+    } catch (...) {
+        clearMatrices();
+        throw;
     }
-    distFile.close();
+}
 
-    return g;
+bool Graph::hasMatrices() const {
+    return distMatrix[0] != nullptr;
+}
+
+double Graph::getMatrixDist(const int u, const int v, const int mode) const {
+    return distMatrix[mode][u][v];
+}
+
+int Graph::getMatrixPath(const int u, const int v, const int mode) const {
+    return pathMatrix[mode][u][v];
 }
@@ -10,12 +10,26 @@
 #include <vector>
 #include <limits>
 #include <string>
-#include "MutablePriorityQueue.h"
+#include <string_view>
+#include <unordered_map>
+#include <span>
+#include <memory>
+#include "CSRGraph.h"
+#include "ObjectPool.h"
 
 #define INF std::numeric_limits<double>::max()
 
 class Edge;
 
+/**
+ * @brief How Graph::computeMatrices() fills the all-pairs matrices.
+ */
+enum class MatrixMethod {
+    Auto,          ///< Floyd-Warshall if the graph is dense enough, otherwise one Dijkstra per source.
+    Dijkstra,      ///< One Dijkstra per source, spread over the threads.
+    FloydWarshall  ///< Blocked Floyd-Warshall, its tiles spread over the threads.
+};
+
 /************************* Vertex  **************************/
 
 /**
@@ -33,15 +47,6 @@ public:
      */
     Vertex(const std::string& name, const int& id, const std::string& code, const bool& park);
 
-    /**
-     * @brief Comparison operator for Vertex.
-     *
-     * Required by the MutablePriorityQueue.
-     *
-     * @param vertex The vertex to compare with.
-     * @return true if this vertex is considered less than the other.
-     */
-    bool operator<(const Vertex &vertex) const;
 
     /**
      * @brief Gets the name of the vertex.
@@ -57,6 +62,13 @@ public:
      */
     int getId() const;
 
+    /**
+     * @brief Gets the dense index of the vertex (its position in the vertex set).
+     *
+     * @return The index of the vertex.
+     */
+    int getIndex() const;
+
     /**
      * @brief Gets the code associated with the vertex.
      *
@@ -74,46 +86,22 @@ public:
     /**
      * @brief Gets the outgoing edges from the vertex.
      *
-     * @return A vector of pointers to Edge representing adjacent edges.
+     * @return A non-owning view of the pointers to Edge representing adjacent edges, valid until the
+     * edges of the vertex change.
      */
-    std::vector<Edge *> getAdj() const;
+    std::span<Edge *const> getAdj() const;
 
-    /**
-     * @brief Checks if the vertex has been visited.
-     *
-     * @return True if visited, false otherwise.
-     */
-    bool isVisited() const;
 
-    /**
-     * @brief Gets the distance from the source vertex.
-     *
-     * @param mode The mode of travel (e.g., 0 for driving, 1 for walking).
-     * @return The distance as a double.
-     */
-    double getDist(int mode = -1) const;
 
-    /**
-     * @brief Gets the previous edge in the shortest path.
-     *
-     * @param mode The mode of travel (e.g., 0 for driving, 1 for walking).
-     * @return Pointer to the Edge in the path.
-     */
-    Edge *getPath(int mode) const;
 
     /**
      * @brief Gets the incoming edges to the vertex.
      *
-     * @return A vector of pointers to Edge representing incoming edges.
+     * @return A non-owning view of the pointers to Edge representing incoming edges, valid until the
+     * edges of the vertex change.
      */
-    std::vector<Edge *> getIncoming() const;
+    std::span<Edge *const> getIncoming() const;
 
-    /**
-     * @brief Checks if the vertex is marked to be avoided.
-     *
-     * @return True if marked as avoiding, false otherwise.
-     */
-    bool isAvoiding() const;
 
     /**
      * @brief Sets the name of the vertex.
@@ -129,6 +117,13 @@ public:
      */
     void setId(const int& newId);
 
+    /**
+     * @brief Sets the dense index of the vertex.
+     *
+     * @param newIndex The new index for the vertex.
+     */
+    void setIndex(int newIndex);
+
     /**
      * @brief Sets the code of the vertex.
      *
@@ -143,35 +138,9 @@ public:
      */
     void setPark(bool newPark);
 
-    /**
-     * @brief Sets the visited flag for the vertex.
-     *
-     * @param visited Boolean indicating if the vertex has been visited.
-     */
-    void setVisited(bool visited);
 
-    /**
-     * @brief Sets the distance for the vertex.
-     *
-     * @param dist The distance to be set.
-     * @param mode The mode of travel (e.g., 0 for driving, 1 for walking).
-     */
-    void setDist(double dist, int mode);
 
-    /**
-     * @brief Sets the previous edge in the path.
-     *
-     * @param path Pointer to the edge that precedes this vertex.
-     * @param mode The mode of travel (e.g., 0 for driving, 1 for walking).
-     */
-    void setPath(Edge *path, int mode);
 
-    /**
-     * @brief Sets the avoiding flag for the vertex.
-     *
-     * @param avoid Boolean indicating whether to avoid this vertex.
-     */
-    void setAvoiding(bool avoid);
 
     /**
      * @brief Adds an edge from this vertex to a destination vertex.
@@ -196,27 +165,19 @@ public:
      */
     void removeOutgoingEdges();
 
-    // Friend declaration for MutablePriorityQueue
-    friend class MutablePriorityQueue<Vertex>;
-
 protected:
     std::string name;                 ///< Name of the vertex.
     int id;                           ///< Unique identifier.
+    int index = 0;                    ///< Dense index in the vertex set.
     std::string code;                 ///< Code associated with the vertex.
     bool park;                        ///< Indicates if the vertex is a park.
 
     std::vector<Edge *> adj;          ///< Outgoing edges.
-
-    bool visited = false;             ///< Visited flag.
-    double driveDist = INF;           ///< Distance for driving mode.
-    Edge *drivePath = nullptr;        ///< Previous edge in driving mode.
-    double walkDist = INF;            ///< Distance for walking mode.
-    Edge *walkPath = nullptr;         ///< Previous edge in walking mode.
-    bool avoid = false;               ///< Flag to indicate avoiding this vertex.
-    double dist = INF;                ///< Distance for driving mode.
     std::vector<Edge *> incoming;     ///< Incoming edges.
 
-    int queueIndex = 0;               ///< Required by MutablePriorityQueue and UFDS.
+    ObjectPool<Edge> *edgePool = nullptr; ///< Arena of the owning Graph (nullptr: edges use new/delete).
+
+    friend class Graph;
 
     /**
      * @brief Deletes a specified edge.
@@ -264,19 +225,7 @@ public:
      */
     Edge *getReverse() const;
 
-    /**
-     * @brief Checks if the edge is marked to be avoided.
-     *
-     * @return True if the edge is to be avoided, false otherwise.
-     */
-    bool isAvoiding() const;
 
-    /**
-     * @brief Sets the avoiding flag for the edge.
-     *
-     * @param avoid Boolean indicating whether to avoid this edge.
-     */
-    void setAvoiding(bool avoid);
 
     /**
      * @brief Sets the reverse edge pointer.
@@ -327,46 +276,104 @@ public:
      * @brief Gets the time for the edge for a given mode.
      *
      * @param mode The mode of travel (e.g., 0 for driving, 1 for walking).
-     * @return The time as a double.
+     * @return The time as a double, or -1 for an unknown mode.
      */
     double getTime(int mode) const;
+
+    /**
+     * @brief Gets the time for the edge for a mode known at compile time.
+     *
+     * @tparam Mode DRIVING or WALKING.
+     * @return The time as a double.
+     */
+    template <int Mode>
+    double getTime() const {
+        if constexpr (Mode == DRIVING) return drive;
+        else return walk;
+    }
 protected:
     Vertex *dest;  ///< Destination vertex.
     Vertex *orig;  ///< Origin vertex.
     Edge *reverse = nullptr;  ///< Pointer to the reverse edge (if bidirectional).
-    bool avoid;    ///< Flag to indicate if the edge should be avoided.
     double drive;  ///< Driving weight.
     double walk;   ///< Walking weight.
 };
 
 /********************** Graph  ****************************/
 
+/**
+ * @brief Transparent string hash, so the code index can be searched with a string_view without
+ * building a std::string.
+ */
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
 /**
  * @brief Class representing a graph.
  */
 class Graph {
 public:
+    Graph() = default;
+
     /**
      * @brief Destructor for the Graph.
+     *
+     * @details Destroys every vertex and frees the vertex and edge arenas in one step each.
      */
     ~Graph();
 
+    /**
+     * @brief Move constructor. The other graph is left empty.
+     *
+     * @param other The graph to take the vertices, edges and indexes from.
+     */
+    Graph(Graph &&other) noexcept;
+
+    /**
+     * @brief Move assignment. Frees the vertices and edges currently held and takes the ones of other,
+     * which is left empty.
+     *
+     * @param other The graph to take the vertices, edges and indexes from.
+     * @return Reference to this graph.
+     */
+    Graph &operator=(Graph &&other) noexcept;
+
+    // Vertices and edges are owned by the graph's arenas, so a graph cannot be copied.
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+
     /**
      * @brief Finds a vertex by its code.
      *
      * @param code The code to search for.
      * @return Pointer to the Vertex if found, otherwise nullptr.
+     *
+     * @note Time Complexity: O(1) on average (hash index).
      */
-    Vertex *findVertex(const std::string &code) const;
+    Vertex *findVertex(std::string_view code) const;
 
     /**
      * @brief Finds a vertex by its identifier.
      *
      * @param id The identifier to search for.
      * @return Pointer to the Vertex if found, otherwise nullptr.
+     *
+     * @note Time Complexity: O(1) on average (hash index).
      */
     Vertex *findVertex(const int &id) const;
 
+    /**
+     * @brief Maps an external vertex id to its dense index.
+     *
+     * @param id The identifier to search for.
+     * @return The dense index of the vertex (as used by the CSR) if found, otherwise -1.
+     *
+     * @note Time Complexity: O(1) on average (hash index).
+     */
+    int findVertexIndex(const int &id) const;
+
     /**
      * @brief Adds a vertex to the graph.
      *
@@ -395,7 +402,7 @@ public:
      * @param drive Weight for driving mode.
      * @return True if the edge was added successfully, false otherwise.
      */
-    bool addEdge(const std::string &sourceName, const std::string &destName, double walk, double drive) const;
+    bool addEdge(std::string_view sourceName, std::string_view destName, double walk, double drive) const;
 
     /**
      * @brief Removes an edge from the graph using vertex names.
@@ -415,7 +422,7 @@ public:
      * @param drive Weight for driving mode.
      * @return True if both edges were added successfully, false otherwise.
      */
-    bool addBidirectionalEdge(const std::string &sourceName, const std::string &destName, double walk, double drive) const;
+    bool addBidirectionalEdge(std::string_view sourceName, std::string_view destName, double walk, double drive) const;
 
     /**
      * @brief Gets the number of vertices in the graph.
@@ -427,15 +434,106 @@ public:
     /**
      * @brief Retrieves the set of vertices in the graph.
      *
-     * @return A vector of pointers to Vertex representing the vertex set.
+     * @return A non-owning view of the pointers to Vertex representing the vertex set, valid until
+     * a vertex is added or removed.
+     */
+    std::span<Vertex *const> getVertexSet() const;
+
+    /**
+     * @brief Builds the CSR representation used by the route searches.
+     *
+     * @details Must be called again after the graph is modified, since the CSR is a snapshot of
+     * the adjacency lists. initialize() calls it once the files are loaded.
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    void buildCSR();
+
+    /**
+     * @brief Gets the CSR representation of the graph.
+     *
+     * @return Reference to the CSRGraph built by buildCSR().
+     */
+    const CSRGraph &getCSR() const;
+
+    /**
+     * @brief Creates every edge of the graph from a CSR built for its vertices.
+     *
+     * @details Used by the parallel loader. The outgoing edges of each vertex are created in CSR order, so they are
+     * the same as when the edges are added one by one, and the incoming edges in the order of CSRGraph::incoming(...).
+     * The given CSR becomes the one used by the searches, so buildCSR() does not need to be called. Edges paired in
+     * reverse are linked as by addBidirectionalEdge(...).
+     *
+     * @param newCsr The edges, built for this graph's vertex set. The graph must have no edges yet.
+     * @param reverse The id of the reverse of each edge, or -1 if it has none.
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    void setEdges(CSRGraph &&newCsr, std::span<const int> reverse);
+
+    /**
+     * @brief Fills the all-pairs distance and path matrices of both modes of travel.
+     *
+     * @details For every pair of dense indices, distMatrix[mode][u][v] is the time of the fastest route from u
+     * to v (INF if there is none) and pathMatrix[mode][u][v] is the id of the CSR edge that ends it (-1 if none).
+     * One Dijkstra per source finds the same routes as dijkstra() with the binary heap; Floyd-Warshall may pick
+     * another one when several are equally fast. Both matrices take 2 * V^2 * 12 bytes, so this is meant for
+     * small and medium graphs. They are a snapshot of the CSR: buildCSR() frees them.
+     *
+     * @param method The algorithm used; Auto chooses by the density of the graph.
+     * @param threads Number of threads; 0 picks one per core.
+     *
+     * @throws std::bad_alloc If the matrices do not fit in memory; the graph is then left without matrices.
+     *
+     * @note Time Complexity: O(V * (V + E) * log V) with Dijkstra, O(V^3) with Floyd-Warshall.
+     */
+    void computeMatrices(MatrixMethod method = MatrixMethod::Auto, unsigned threads = 0);
+
+    /**
+     * @brief Tells whether computeMatrices() was called since the CSR was last built.
+     *
+     * @return True if the all-pairs matrices are filled, false otherwise.
      */
-    std::vector<Vertex *> getVertexSet() const;
+    bool hasMatrices() const;
+
+    /**
+     * @brief Gets the time of the fastest route between two vertices from the all-pairs matrices.
+     *
+     * @param u The dense index of the origin.
+     * @param v The dense index of the destination.
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return The time of the route, INF if there is none.
+     *
+     * @note Time Complexity: O(1).
+     */
+    double getMatrixDist(int u, int v, int mode) const;
+
+    /**
+     * @brief Gets the last edge of the fastest route between two vertices from the all-pairs matrices.
+     *
+     * @param u The dense index of the origin.
+     * @param v The dense index of the destination.
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return The id of the CSR edge that reaches v, -1 if there is none or u == v.
+     *
+     * @note Time Complexity: O(1).
+     */
+    int getMatrixPath(int u, int v, int mode) const;
 
 protected:
     std::vector<Vertex *> vertexSet; ///< Set of vertices in the graph.
+    std::unordered_map<int, int> idIndex;            ///< External id -> dense index in vertexSet.
+    std::unordered_map<std::string, int, StringHash, std::equal_to<>> codeIndex;  ///< Code -> dense index in vertexSet.
+
+    CSRGraph csr;                    ///< Flat adjacency used by the searches.
+
+    // Heap-allocated so that their addresses (kept by every Vertex) survive a move of the Graph.
+    std::unique_ptr<ObjectPool<Vertex>> vertexPool; ///< Arena holding the vertices.
+    std::unique_ptr<ObjectPool<Edge>> edgePool;     ///< Arena holding the edges.
 
-    double **distMatrix = nullptr;  ///< Distance matrix (e.g., for Floyd-Warshall).
-    int **pathMatrix = nullptr;     ///< Path matrix for reconstruction of shortest paths.
+    double **distMatrix[2] = {nullptr, nullptr};  ///< All-pairs distances of each mode, see computeMatrices().
+    int **pathMatrix[2] = {nullptr, nullptr};     ///< Last edge of each all-pairs route, by mode.
+    int matrixSize = 0;                           ///< Number of rows of the matrices.
 
     /**
      * @brief Finds the index of a vertex by its name.
@@ -444,6 +542,25 @@ protected:
      * @return The index of the vertex if found, otherwise -1.
      */
     int findVertexIdx(const std::string &name) const;
+
+    /**
+     * @brief Renumbers the vertices and rebuilds the id and code indexes.
+     *
+     * @note Time Complexity: O(V).
+     */
+    void rebuildIndex();
+
+    /**
+     * @brief Frees the all-pairs matrices, if any.
+     */
+    void clearMatrices();
+
+    /**
+     * @brief Destroys every vertex and edge and frees the arenas and matrices.
+     */
+    void clear();
+
+    friend class GraphSnapshot;
 };
 
 /**
@@ -465,11 +582,18 @@ void deleteMatrix(double **m, int n);
 /**
  * @brief Project-specific function to initialize the graph.
  *
+ * @details The distances file is split into byte ranges that are parsed on separate threads; their edge
+ * lists are then merged into the adjacency with a parallel counting sort by origin (and by destination for
+ * the incoming lists). The chunks are merged in file order, so the graph is the same whatever the number of
+ * threads. Files with quoted fields are parsed in a single chunk, since a quoted field may span lines.
+ *
  * @param locs The locations file.
  * @param dists The distances file.
+ * @param threads Number of threads (and chunks) for the distances file; 0 picks one per core, with chunks
+ * of at least 64 KiB.
  * @return An initialized Graph object.
  */
-Graph initialize(const std::string& locs, const std::string& dists);
+Graph initialize(const std::string& locs, const std::string& dists, unsigned threads = 0);
 
 #endif // GRAPH_H
 #endif /* DA_TP_CLASSES_GRAPH */
@@ -0,0 +1,233 @@
+#include "GraphSnapshot.h"
+#include "CsvReader.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+
+constexpr char MAGIC[8] = {'D', 'A', 'G', 'R', 'A', 'P', 'H', '\0'};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numVertices;
+    uint32_t numEdges;
+    uint32_t stringBytes;
+    uint64_t locsSize;
+    int64_t locsTime;
+    uint64_t distsSize;
+    int64_t distsTime;
+};
+
+struct VertexRecord {
+    int32_t id;
+    uint32_t park;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t codeOffset;
+    uint32_t codeLength;
+};
+
+// Size and modification time of a source file, used to detect stale snapshots.
+bool fingerprint(const std::string &path, uint64_t &size, int64_t &time) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto t = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    time = t.time_since_epoch().count();
+    return true;
+}
+
+template <class T>
+void writeArray(std::ofstream &out, std::span<const T> v) {
+    out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(v.size_bytes()));
+}
+
+// Points a CSR array at n elements of the mapping (which is page-aligned and keeps every array aligned)
+template <class A>
+const char *viewArray(const char *p, A &array, std::size_t n) {
+    using T = std::remove_cvref_t<decltype(array[0])>;
+    array.view({reinterpret_cast<const T *>(p), n});
+    return p + n * sizeof(T);
+}
+
+}
+
+bool GraphSnapshot::save(const Graph &g, const std::string &path, const std::string &locs, const std::string &dists) {
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    if (!fingerprint(locs, h.locsSize, h.locsTime) || !fingerprint(dists, h.distsSize, h.distsTime))
+        return false;
+
+    const CSRGraph &csr = g.getCSR();
+    h.numVertices = csr.numVertices();
+    h.numEdges = csr.numEdges();
+
+    // Reverse links as edge ids (the edges of each vertex are in CSR order)
+    std::unordered_map<const Edge *, int> edgeIds;
+    for (auto v : g.getVertexSet())
+        for (int e : csr.edges(v->getIndex()))
+            edgeIds.emplace(v->getAdj()[e - csr.begin(v->getIndex())], e);
+    std::vector<int> reverse(h.numEdges, -1);
+    for (auto [edge, e] : edgeIds)
+        if (edge->getReverse() != nullptr) reverse[e] = edgeIds.at(edge->getReverse());
+
+    // Intern names and codes into a single pool
+    std::string pool;
+    std::unordered_map<std::string, uint32_t> interned;
+    auto intern = [&](const std::string &s) {
+        auto [it, inserted] = interned.emplace(s, static_cast<uint32_t>(pool.size()));
+        if (inserted) pool += s;
+        return it->second;
+    };
+    std::vector<VertexRecord> table(h.numVertices);
+    for (auto v : g.getVertexSet()) {
+        VertexRecord &r = table[v->getIndex()];
+        const std::string name = v->getName(), code = v->getCode();
+        r.id = v->getId();
+        r.park = v->isPark();
+        r.nameOffset = intern(name);
+        r.nameLength = name.size();
+        r.codeOffset = intern(code);
+        r.codeLength = code.size();
+    }
+    h.stringBytes = pool.size();
+
+    // Written to a temporary file first, so a reader never sees half a snapshot
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        writeArray(out, csr.driveTimes.span());
+        writeArray(out, csr.walkTimes.span());
+        writeArray(out, csr.offsets.span());
+        writeArray(out, csr.sources.span());
+        writeArray(out, csr.targets.span());
+        writeArray(out, csr.inOffsets.span());
+        writeArray(out, csr.inEdges.span());
+        writeArray(out, std::span<const int>(reverse));
+        writeArray(out, std::span<const VertexRecord>(table));
+        out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+        if (!out.good())
+            return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+bool GraphSnapshot::load(Graph &g, const std::string &path, const std::string &locs, const std::string &dists) {
+    auto file = std::make_shared<const MappedFile>(path);
+    std::string_view data = file->view();
+    if (!file->isOpen() || data.size() < sizeof(Header))
+        return false;
+
+    Header h;
+    std::memcpy(&h, data.data(), sizeof(h));
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION)
+        return false;
+
+    uint64_t size;
+    int64_t time;
+    if (!fingerprint(locs, size, time) || size != h.locsSize || time != h.locsTime)
+        return false;
+    if (!fingerprint(dists, size, time) || size != h.distsSize || time != h.distsTime)
+        return false;
+
+    const uint64_t n = h.numVertices, m = h.numEdges;
+    const uint64_t expected = sizeof(Header) + 2 * m * sizeof(double) + (2 * (n + 1) + 4 * m) * sizeof(int32_t)
+                              + n * sizeof(VertexRecord) + h.stringBytes;
+    if (data.size() != expected)
+        return false;
+
+    // The arrays are read in place from the mapping, which the CSR keeps
+    CSRGraph csr;
+    const char *p = data.data() + sizeof(Header);
+    p = viewArray(p, csr.driveTimes, m);
+    p = viewArray(p, csr.walkTimes, m);
+    p = viewArray(p, csr.offsets, n + 1);
+    p = viewArray(p, csr.sources, m);
+    p = viewArray(p, csr.targets, m);
+    p = viewArray(p, csr.inOffsets, n + 1);
+    p = viewArray(p, csr.inEdges, m);
+    const std::span<const int> reverse(reinterpret_cast<const int *>(p), m);
+    p += m * sizeof(int32_t);
+    const std::span<const VertexRecord> table(reinterpret_cast<const VertexRecord *>(p), n);
+    p += n * sizeof(VertexRecord);
+    const std::string_view pool(p, h.stringBytes);
+    csr.mapping = file;
+
+    // Reject corrupted files before anything is built from them
+    auto isVertex = [n](int u) { return u >= 0 && static_cast<uint64_t>(u) < n; };
+    auto isEdge = [m](int e) { return e >= 0 && static_cast<uint64_t>(e) < m; };
+    if (csr.offsets[0] != 0 || csr.offsets[n] != static_cast<int>(m))
+        return false;
+    if (csr.inOffsets[0] != 0 || csr.inOffsets[n] != static_cast<int>(m))
+        return false;
+    for (uint64_t u = 0; u < n; u++) {
+        if (csr.offsets[u] > csr.offsets[u + 1] || csr.inOffsets[u] > csr.inOffsets[u + 1])
+            return false;
+        for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; e++)
+            if (csr.sources[e] != static_cast<int>(u) || !isVertex(csr.targets[e]))
+                return false;
+        for (int i = csr.inOffsets[u]; i < csr.inOffsets[u + 1]; i++)
+            if (!isEdge(csr.inEdges[i]) || csr.targets[csr.inEdges[i]] != static_cast<int>(u)
+                || (i > csr.inOffsets[u] && csr.inEdges[i - 1] >= csr.inEdges[i]))
+                return false;
+    }
+    for (uint64_t e = 0; e < m; e++) {
+        const int r = reverse[e];
+        if (r != -1 && (!isEdge(r) || reverse[r] != static_cast<int>(e) || csr.sources[r] != csr.targets[e]
+                        || csr.targets[r] != csr.sources[e]))
+            return false;
+    }
+    for (const VertexRecord &r : table)
+        if (uint64_t(r.nameOffset) + r.nameLength > pool.size() || uint64_t(r.codeOffset) + r.codeLength > pool.size())
+            return false;
+
+    Graph res;
+    csr.ids.resize(n);
+    csr.parks.resize(n);
+    for (uint64_t u = 0; u < n; u++) {
+        const VertexRecord &r = table[u];
+        csr.ids[u] = r.id;
+        csr.parks[u] = r.park != 0;
+        if (!res.addVertex(std::string(pool.substr(r.nameOffset, r.nameLength)), r.id,
+                           std::string(pool.substr(r.codeOffset, r.codeLength)), r.park != 0))
+            return false;
+    }
+    csr.buildParkingSpots();
+    csr.buildIntegral();
+    csr.version = CSRGraph::nextVersion();
+
+    // The Vertex/Edge objects mirror the CSR, in the same order and with the same reverse links
+    res.setEdges(std::move(csr), reverse);
+
+    g = std::move(res);
+    return true;
+}
+
+std::string GraphSnapshot::pathFor(const std::string &locs) {
+    return std::filesystem::path(locs).replace_extension(".graph").string();
+}
+
+Graph loadGraph(const std::string &locs, const std::string &dists) {
+    Graph g;
+    const std::string snapshot = GraphSnapshot::pathFor(locs);
+    if (GraphSnapshot::load(g, snapshot, locs, dists))
+        return g;
+    g = initialize(locs, dists);
+    GraphSnapshot::save(g, snapshot, locs, dists); // best effort: the CSV files are used again if this fails
+    return g;
+}
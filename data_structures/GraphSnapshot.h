@@ -0,0 +1,75 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "Graph.h"
+
+/**
+ * @brief Versioned binary snapshot of a Graph.
+ *
+ * @details Layout of a snapshot file (host byte order):
+ *   - Header: magic, format version, vertex/edge/string-pool sizes and the size and modification time of the
+ *     two CSV files it was built from;
+ *   - CSR arrays: drive times, walk times (doubles), offsets, sources, targets, incoming offsets, incoming
+ *     edges and reverse edge ids, -1 if none (int32);
+ *   - vertex table: id, park flag and the offset/length of the name and code in the string pool;
+ *   - string pool: every name and code, interned and concatenated.
+ *
+ * Loading maps the file and the CSR reads its arrays in place, so no text is parsed and no array is copied;
+ * only the Vertex and Edge objects are created, with the reverse links addBidirectionalEdge(...) would set. A
+ * snapshot is only used when its version matches and the CSV files it was built from have not changed since.
+ */
+class GraphSnapshot {
+public:
+    static constexpr uint32_t VERSION = 3; ///< Bumped whenever the layout changes.
+
+    /**
+     * @brief Writes a snapshot of a graph.
+     *
+     * @param g The graph, built from the two CSV files.
+     * @param path The snapshot file to write.
+     * @param locs The locations file the graph was built from.
+     * @param dists The distances file the graph was built from.
+     * @return True if the snapshot was written, false otherwise.
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    static bool save(const Graph &g, const std::string &path, const std::string &locs, const std::string &dists);
+
+    /**
+     * @brief Loads a snapshot if it exists and is up to date.
+     *
+     * @param g Where the graph is loaded to (left unchanged if false is returned).
+     * @param path The snapshot file to read.
+     * @param locs The locations file the snapshot must have been built from.
+     * @param dists The distances file the snapshot must have been built from.
+     * @return True if the graph was loaded, false if the snapshot is missing, stale or invalid.
+     *
+     * @note Time Complexity: O(V + E).
+     */
+    static bool load(Graph &g, const std::string &path, const std::string &locs, const std::string &dists);
+
+    /**
+     * @brief Gets the snapshot path used for a dataset.
+     *
+     * @param locs The locations file of the dataset.
+     * @return The locations path with its extension replaced by ".graph".
+     */
+    static std::string pathFor(const std::string &locs);
+};
+
+/**
+ * @brief Loads a dataset, preferring its binary snapshot.
+ *
+ * @details Uses the snapshot next to the locations file when it is present and up to date; otherwise the CSV
+ * files are parsed with initialize() and a new snapshot is written (if the directory is writable) for the
+ * next start.
+ *
+ * @param locs The locations file.
+ * @param dists The distances file.
+ * @return The loaded Graph.
+ */
+Graph loadGraph(const std::string &locs, const std::string &dists);
+
+#endif //GRAPHSNAPSHOT_H
@@ -0,0 +1,22 @@
+#ifndef HIERARCHYMETRIC_H
+#define HIERARCHYMETRIC_H
+
+#include <vector>
+
+/**
+ * @brief Weights of the arcs of a CustomizableHierarchy for one set of restrictions.
+ *
+ * @details Arc a joins a lower ranked and a higher ranked vertex; "up" is the direction lower -> higher and "down"
+ * the opposite one. Each weight is either an original edge (via -1, edge set) or the path through a lower ranked
+ * vertex that both ends are joined to (via set), which is how routes are unpacked.
+ */
+struct HierarchyMetric {
+    std::vector<double> up;      ///< Weight of each arc upwards (INF if it cannot be used).
+    std::vector<double> down;    ///< Weight of each arc downwards (INF if it cannot be used).
+    std::vector<int> upVia;      ///< Middle vertex of the upward weight, or -1 if it is an original edge.
+    std::vector<int> downVia;    ///< Middle vertex of the downward weight, or -1 if it is an original edge.
+    std::vector<int> upEdge;     ///< CSR id of the original edge upwards (-1 if none).
+    std::vector<int> downEdge;   ///< CSR id of the original edge downwards (-1 if none).
+};
+
+#endif //HIERARCHYMETRIC_H
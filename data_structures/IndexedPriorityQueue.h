@@ -0,0 +1,82 @@
+/*
+ * IndexedPriorityQueue.h
+ * Mutable binary heap over dense vertex indices, keyed by an external distance array.
+ */
+
+#ifndef DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+#define DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+
+#include <vector>
+
+/**
+ * key[i] is the priority of index i and pos[i] is where the queue keeps its position in the heap
+ * (pos must have one entry per index that can be inserted).
+ */
+class IndexedPriorityQueue {
+    std::vector<int> H;
+    const std::vector<double> &key;
+    std::vector<int> &pos;
+    void heapifyUp(unsigned i);
+    void heapifyDown(unsigned i);
+    void set(unsigned i, int x) { H[i] = x; pos[x] = static_cast<int>(i); }
+
+public:
+    IndexedPriorityQueue(const std::vector<double> &key, std::vector<int> &pos);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    int top() const { return H[1]; }
+    bool empty() const { return H.size() == 1; }
+};
+
+inline IndexedPriorityQueue::IndexedPriorityQueue(const std::vector<double> &key, std::vector<int> &pos)
+    : key(key), pos(pos) {
+    H.push_back(-1);
+    // indices will be used starting in 1
+    // to facilitate parent/child calculations
+}
+
+inline int IndexedPriorityQueue::extractMin() {
+    int x = H[1];
+    H[1] = H.back();
+    H.pop_back();
+    if (H.size() > 1) heapifyDown(1);
+    pos[x] = 0;
+    return x;
+}
+
+inline void IndexedPriorityQueue::insert(int x) {
+    H.push_back(x);
+    heapifyUp(H.size() - 1);
+}
+
+inline void IndexedPriorityQueue::decreaseKey(int x) {
+    heapifyUp(pos[x]);
+}
+
+inline void IndexedPriorityQueue::heapifyUp(unsigned i) {
+    int x = H[i];
+    while (i > 1 && key[x] < key[H[i / 2]]) {
+        set(i, H[i / 2]);
+        i = i / 2;
+    }
+    set(i, x);
+}
+
+inline void IndexedPriorityQueue::heapifyDown(unsigned i) {
+    int x = H[i];
+    while (true) {
+        unsigned k = i * 2;
+        if (k >= H.size())
+            break;
+        if (k + 1 < H.size() && key[H[k + 1]] < key[H[k]])
+            ++k; // right child of i
+        if (!(key[H[k]] < key[x]))
+            break;
+        set(i, H[k]);
+        i = k;
+    }
+    set(i, x);
+}
+
+#endif /* DA_TP_CLASSES_INDEXEDPRIORITYQUEUE */
@@ -0,0 +1,195 @@
+#include "LandmarkTable.h"
+#include "CsvReader.h"
+#include "Graph.h"
+#include "IndexedPriorityQueue.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr char MAGIC[8] = {'D', 'A', 'L', 'A', 'N', 'D', 'M', 'K'};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numVertices;
+    uint32_t numEdges;
+    uint32_t numLandmarks;
+    uint64_t graphHash;
+};
+
+// Distances from s to every vertex (forward), or from every vertex to s (backward), on the whole graph
+std::vector<double> distances(const CSRGraph &csr, int s, int mode, bool backward) {
+    std::vector<double> dist(csr.numVertices(), std::numeric_limits<double>::max());
+    std::vector<int> pos(csr.numVertices(), 0);
+    IndexedPriorityQueue q(dist, pos);
+    dist[s] = 0;
+    q.insert(s);
+    auto scan = [&](int v, int e, int w) {
+        if (csr.time(e, mode) == -1) return;
+        double d = dist[v] + csr.time(e, mode);
+        if (d < dist[w]) {
+            bool inQueue = dist[w] != std::numeric_limits<double>::max();
+            dist[w] = d;
+            inQueue ? q.decreaseKey(w) : q.insert(w);
+        }
+    };
+    while (!q.empty()) {
+        int v = q.extractMin();
+        if (backward) {
+            for (int e : csr.incoming(v)) scan(v, e, csr.source(e));
+        } else {
+            for (int e : csr.edges(v)) scan(v, e, csr.target(e));
+        }
+    }
+    return dist;
+}
+
+// Writes column l of a table stored as table[v*k + l]
+void setColumn(std::vector<double> &table, int k, int l, const std::vector<double> &column) {
+    for (std::size_t v = 0; v < column.size(); v++)
+        table[v * k + l] = column[v];
+}
+
+template <class T>
+void writeArray(std::ofstream &out, const std::vector<T> &v) {
+    out.write(reinterpret_cast<const char *>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+template <class T>
+const char *readArray(const char *p, std::vector<T> &v, std::size_t n) {
+    v.resize(n);
+    std::memcpy(v.data(), p, n * sizeof(T));
+    return p + n * sizeof(T);
+}
+
+}
+
+void LandmarkTable::build(const CSRGraph &csr, int count) {
+    const int n = csr.numVertices();
+    count = std::max(0, std::min(count, n));
+    landmarks.clear();
+    for (auto *t : {&fromDrive, &toDrive, &fromWalk, &toWalk})
+        t->assign(static_cast<std::size_t>(n) * count, INF_DIST);
+
+    // Farthest selection: start with the vertex farthest from vertex 0, then keep taking the vertex whose
+    // walking distance to the closest chosen landmark is the largest (unreachable vertices first)
+    std::vector<double> closest(n, INF_DIST);
+    std::vector<double> seed = n > 0 ? distances(csr, 0, WALKING, false) : std::vector<double>();
+    int next = static_cast<int>(std::max_element(seed.begin(), seed.end()) - seed.begin());
+    for (int l = 0; l < count; l++) {
+        landmarks.push_back(next);
+        const std::vector<double> fromWalkL = distances(csr, next, WALKING, false);
+        setColumn(fromDrive, count, l, distances(csr, next, DRIVING, false));
+        setColumn(toDrive, count, l, distances(csr, next, DRIVING, true));
+        setColumn(fromWalk, count, l, fromWalkL);
+        setColumn(toWalk, count, l, distances(csr, next, WALKING, true));
+
+        next = 0;
+        for (int v = 0; v < n; v++) {
+            closest[v] = std::min(closest[v], fromWalkL[v]);
+            if (closest[v] > closest[next]) next = v;
+        }
+    }
+}
+
+uint64_t LandmarkTable::hash(const CSRGraph &csr) {
+    // FNV-1a over the edges, in CSR order
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void *data, std::size_t size) {
+        const auto *p = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+    };
+    for (int u = 0; u < csr.numVertices(); u++) {
+        const int degree = csr.end(u) - csr.begin(u);
+        mix(&degree, sizeof(degree));
+        for (int e : csr.edges(u)) {
+            const int t = csr.target(e);
+            const double d = csr.drive(e), w = csr.walk(e);
+            mix(&t, sizeof(t));
+            mix(&d, sizeof(d));
+            mix(&w, sizeof(w));
+        }
+    }
+    return h;
+}
+
+bool LandmarkTable::save(const CSRGraph &csr, const std::string &path) const {
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.numVertices = csr.numVertices();
+    h.numEdges = csr.numEdges();
+    h.numLandmarks = size();
+    h.graphHash = hash(csr);
+
+    // Written to a temporary file first, so a reader never sees half a table
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        writeArray(out, landmarks);
+        writeArray(out, fromDrive);
+        writeArray(out, toDrive);
+        writeArray(out, fromWalk);
+        writeArray(out, toWalk);
+        if (!out.good())
+            return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+bool LandmarkTable::load(const CSRGraph &csr, const std::string &path, int count) {
+    MappedFile file(path);
+    std::string_view data = file.view();
+    if (!file.isOpen() || data.size() < sizeof(Header))
+        return false;
+
+    Header h;
+    std::memcpy(&h, data.data(), sizeof(h));
+    const uint64_t n = csr.numVertices(), k = std::max(0, std::min(count, csr.numVertices()));
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION || h.numVertices != n
+        || h.numEdges != static_cast<uint64_t>(csr.numEdges()) || h.numLandmarks != k)
+        return false;
+    if (data.size() != sizeof(Header) + k * sizeof(int32_t) + 4 * n * k * sizeof(double))
+        return false;
+    if (h.graphHash != hash(csr))
+        return false;
+
+    LandmarkTable res;
+    const char *p = data.data() + sizeof(Header);
+    p = readArray(p, res.landmarks, k);
+    p = readArray(p, res.fromDrive, n * k);
+    p = readArray(p, res.toDrive, n * k);
+    p = readArray(p, res.fromWalk, n * k);
+    readArray(p, res.toWalk, n * k);
+    for (int l : res.landmarks)
+        if (l < 0 || static_cast<uint64_t>(l) >= n)
+            return false;
+
+    *this = std::move(res);
+    return true;
+}
+
+std::string LandmarkTable::pathFor(const std::string &locs) {
+    return std::filesystem::path(locs).replace_extension(".landmarks").string();
+}
+
+LandmarkTable loadLandmarks(const Graph &g, const std::string &locs, int count) {
+    LandmarkTable table;
+    const std::string path = LandmarkTable::pathFor(locs);
+    if (table.load(g.getCSR(), path, count))
+        return table;
+    table.build(g.getCSR(), count);
+    table.save(g.getCSR(), path); // best effort: the table is built again next time if this fails
+    return table;
+}
@@ -0,0 +1,133 @@
+#ifndef LANDMARKTABLE_H
+#define LANDMARKTABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "CSRGraph.h"
+
+class Graph;
+
+/**
+ * @brief Landmark distances for goal-directed (ALT) searches.
+ *
+ * @details For each landmark L and each mode, the table keeps the distance from L to every vertex and from every
+ * vertex to L, computed on the whole graph (non-drivable edges excluded when driving). By the triangle inequality
+ * max(d(L,t) - d(L,u), d(u,L) - d(t,L)) never exceeds d(u,t), which gives A* a lower bound that stays valid when
+ * vertices or edges are avoided, since that can only make distances longer.
+ * Landmarks are chosen by farthest selection: each new one is the vertex farthest (walking) from the ones
+ * already chosen.
+ *
+ * Layout of a landmark file (host byte order): header (magic, format version, vertex/edge/landmark counts and
+ * a hash of the graph), landmark indices (int32), then the from/to tables of driving and of walking (doubles,
+ * all landmarks of a vertex next to each other).
+ */
+class LandmarkTable {
+public:
+    static constexpr uint32_t VERSION = 1;      ///< Bumped whenever the layout changes.
+    static constexpr int DEFAULT_COUNT = 16;    ///< Landmarks used when no count is given.
+
+    /**
+     * @brief Chooses the landmarks and computes their distances.
+     *
+     * @param csr The graph.
+     * @param count The number of landmarks (at most the number of vertices).
+     *
+     * @note Time Complexity: O(k(V+E)logV) where k is the number of landmarks.
+     */
+    void build(const CSRGraph &csr, int count);
+
+    /**
+     * @brief Writes the table to a file.
+     *
+     * @param csr The graph the table was built for.
+     * @param path The file to write.
+     * @return True if the file was written, false otherwise.
+     *
+     * @note Time Complexity: O(E + kV).
+     */
+    bool save(const CSRGraph &csr, const std::string &path) const;
+
+    /**
+     * @brief Loads a table if it exists and was built for this graph with this number of landmarks.
+     *
+     * @param csr The graph the table must have been built for.
+     * @param path The file to read.
+     * @param count The number of landmarks wanted.
+     * @return True if the table was loaded, false if the file is missing, stale or invalid.
+     *
+     * @note Time Complexity: O(E + kV).
+     */
+    bool load(const CSRGraph &csr, const std::string &path, int count);
+
+    /**
+     * @brief Gets the landmark file path used for a dataset.
+     *
+     * @param locs The locations file of the dataset.
+     * @return The locations path with its extension replaced by ".landmarks".
+     */
+    static std::string pathFor(const std::string &locs);
+
+    /**
+     * @brief Gets the number of landmarks.
+     *
+     * @return The number of landmarks (0 if the table was not built).
+     */
+    int size() const { return static_cast<int>(landmarks.size()); }
+
+    /**
+     * @brief Gets a lower bound of the distance between two vertices.
+     *
+     * @tparam Mode DRIVING or WALKING.
+     * @param u The dense index of the first vertex.
+     * @param t The dense index of the second vertex.
+     * @return A value between 0 and d(u,t).
+     *
+     * @note Time Complexity: O(k).
+     */
+    template <int Mode>
+    double lowerBound(int u, int t) const {
+        const int k = size();
+        const double *from = (Mode == DRIVING ? fromDrive : fromWalk).data();
+        const double *to = (Mode == DRIVING ? toDrive : toWalk).data();
+        const double *fu = from + u * k, *ft = from + t * k, *tu = to + u * k, *tt = to + t * k;
+        double res = 0;
+        for (int l = 0; l < k; l++) {
+            // Unreachable pairs (INF) say nothing useful and are skipped
+            if (ft[l] != INF_DIST && fu[l] != INF_DIST) res = std::max(res, ft[l] - fu[l]);
+            if (tu[l] != INF_DIST && tt[l] != INF_DIST) res = std::max(res, tu[l] - tt[l]);
+        }
+        return res;
+    }
+
+private:
+    static constexpr double INF_DIST = std::numeric_limits<double>::max();
+
+    /**
+     * @brief Hash of the structure and the weights of a graph, used to detect stale files.
+     */
+    static uint64_t hash(const CSRGraph &csr);
+
+    std::vector<int> landmarks;     ///< Dense index of each landmark.
+    std::vector<double> fromDrive;  ///< fromDrive[v*k + l]: driving time from landmark l to v.
+    std::vector<double> toDrive;    ///< toDrive[v*k + l]: driving time from v to landmark l.
+    std::vector<double> fromWalk;   ///< fromWalk[v*k + l]: walking time from landmark l to v.
+    std::vector<double> toWalk;     ///< toWalk[v*k + l]: walking time from v to landmark l.
+};
+
+/**
+ * @brief Loads the landmark table of a dataset, building it if needed.
+ *
+ * @details Uses the file next to the locations file when it matches the graph and the number of landmarks;
+ * otherwise the table is built and written (if the directory is writable) for the next start.
+ *
+ * @param g The graph of the dataset.
+ * @param locs The locations file of the dataset.
+ * @param count The number of landmarks.
+ * @return The landmark table.
+ */
+LandmarkTable loadLandmarks(const Graph &g, const std::string &locs, int count = LandmarkTable::DEFAULT_COUNT);
+
+#endif //LANDMARKTABLE_H
@@ -0,0 +1,77 @@
+/*
+ * ObjectPool.h
+ * Arena of fixed-size objects, allocated in contiguous slabs and freed all at once.
+ */
+
+#ifndef DA_TP_CLASSES_OBJECTPOOL
+#define DA_TP_CLASSES_OBJECTPOOL
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Objects are constructed in slabs of slabSize elements. destroy() runs the destructor and keeps the slot
+ * for reuse; release() frees every slab in one step without running destructors, so the owner has to
+ * destroy the live objects first when T is not trivially destructible.
+ */
+template <class T>
+class ObjectPool {
+    std::vector<T *> slabs;
+    std::vector<T *> freeList;
+    std::size_t slabSize;
+    std::size_t used;  // slots taken in the last slab
+
+public:
+    explicit ObjectPool(std::size_t slabSize = 1024);
+    ~ObjectPool();
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <class... Args>
+    T *create(Args &&... args);
+    void destroy(T *x);
+    void release();
+};
+
+template <class T>
+ObjectPool<T>::ObjectPool(std::size_t slabSize) : slabSize(slabSize), used(slabSize) { }
+
+template <class T>
+ObjectPool<T>::~ObjectPool() {
+    release();
+}
+
+template <class T>
+template <class... Args>
+T *ObjectPool<T>::create(Args &&... args) {
+    T *slot;
+    if (!freeList.empty()) {
+        slot = freeList.back();
+        freeList.pop_back();
+    } else {
+        if (used == slabSize) {
+            slabs.push_back(std::allocator<T>().allocate(slabSize));
+            used = 0;
+        }
+        slot = slabs.back() + used++;
+    }
+    return new (slot) T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void ObjectPool<T>::destroy(T *x) {
+    x->~T();
+    freeList.push_back(x);
+}
+
+template <class T>
+void ObjectPool<T>::release() {
+    for (T *slab : slabs)
+        std::allocator<T>().deallocate(slab, slabSize);
+    slabs.clear();
+    freeList.clear();
+    used = slabSize;
+}
+
+#endif /* DA_TP_CLASSES_OBJECTPOOL */
@@ -0,0 +1,73 @@
+#ifndef PARKCANDIDATES_H
+#define PARKCANDIDATES_H
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief The k best parking spots offered to it, for the approximate routes of DrivingWalking.
+ *
+ * @details Parking spots are offered as the driving search settles them. A spot is better than another if its
+ * total time (driving plus walking) is smaller or, on equal totals, if its index is greater, which is the order
+ * betterPark(...) gives when the spots are compared by increasing index. Only the k best are kept, in a heap whose
+ * top is the worst of them, so ranking every park of the graph never costs more than O(P log k).
+ */
+class ParkCandidates {
+public:
+    /**
+     * @brief Creates an empty set of candidates.
+     *
+     * @param k Number of parking spots to keep.
+     */
+    explicit ParkCandidates(int k) : k(k) { }
+
+    /**
+     * @brief Offers a parking spot, which is kept if it is among the k best so far.
+     *
+     * @param v The dense index of the parking spot.
+     * @param total Its driving plus walking time.
+     *
+     * @note Time Complexity: O(log k).
+     */
+    void offer(int v, double total) {
+        const Candidate c{total, v};
+        if (static_cast<int>(heap.size()) < k) {
+            heap.push_back(c);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (k > 0 && better(c, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = c;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+
+    /**
+     * @brief Gets the parking spots kept, the best first.
+     *
+     * @return Their dense indices (at most k).
+     *
+     * @note Time Complexity: O(k log k).
+     */
+    std::vector<int> ranked() const {
+        std::vector<Candidate> sorted = heap;
+        std::sort(sorted.begin(), sorted.end(), better);
+        std::vector<int> res;
+        for (const Candidate &c : sorted) res.push_back(c.vertex);
+        return res;
+    }
+
+private:
+    struct Candidate {
+        double total;
+        int vertex;
+    };
+
+    static bool better(const Candidate &a, const Candidate &b) {
+        return a.total != b.total ? a.total < b.total : a.vertex > b.vertex;
+    }
+
+    int k;
+    std::vector<Candidate> heap;  ///< Max-heap by better(...): the worst candidate kept is on top.
+};
+
+#endif //PARKCANDIDATES_H
@@ -0,0 +1,80 @@
+/*
+ * RadixHeap.h
+ * Monotone radix heap over dense vertex indices, keyed by an external distance array.
+ * Same interface as IndexedPriorityQueue. It only works when keys are non-negative and no key smaller than
+ * the last extracted one is ever inserted, which is always the case in Dijkstra's algorithm.
+ */
+
+#ifndef DA_TP_CLASSES_RADIXHEAP
+#define DA_TP_CLASSES_RADIXHEAP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Keys are bucketed by the highest bit in which they differ from the last extracted key, so each entry
+ * moves down at most 64 times in total. Non-negative doubles compare like their bit patterns, which are used
+ * as the radix keys.
+ * decreaseKey inserts a new entry instead of moving the old one; an entry is stale (and dropped) once its key
+ * no longer matches key[x]. pos is not needed and is accepted only to keep the interface of the other queues.
+ */
+class RadixHeap {
+    using Entry = std::pair<uint64_t, int>; // (key bits, index)
+    std::array<std::vector<Entry>, 65> buckets;
+    const std::vector<double> &key;
+    uint64_t last = 0; // bits of the last extracted key
+    int live = 0;      // number of indices in the queue (stale entries not counted)
+    static uint64_t bits(double d) { return std::bit_cast<uint64_t>(d); }
+    unsigned bucketOf(uint64_t k) const { return k == last ? 0 : 64 - std::countl_zero(k ^ last); }
+    bool stale(const Entry &e) const { return e.first != bits(key[e.second]); }
+    void push(int x) { uint64_t k = bits(key[x]); buckets[bucketOf(k)].emplace_back(k, x); }
+
+public:
+    RadixHeap(const std::vector<double> &key, std::vector<int> &pos);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    bool empty() const { return live == 0; }
+};
+
+inline RadixHeap::RadixHeap(const std::vector<double> &key, std::vector<int> &) : key(key) { }
+
+inline int RadixHeap::extractMin() {
+    while (true) {
+        if (buckets[0].empty()) {
+            // Redistribute the first non-empty bucket around its minimum
+            unsigned i = 1;
+            while (buckets[i].empty()) i++;
+            uint64_t min = UINT64_MAX;
+            for (const Entry &e : buckets[i])
+                if (!stale(e) && e.first < min) min = e.first;
+            if (min != UINT64_MAX) { // otherwise the bucket only had stale entries
+                last = min;
+                for (const Entry &e : buckets[i])
+                    if (!stale(e)) buckets[bucketOf(e.first)].push_back(e); // always lands below i
+            }
+            buckets[i].clear();
+            continue;
+        }
+        Entry e = buckets[0].back();
+        buckets[0].pop_back();
+        if (stale(e))
+            continue;
+        live--;
+        return e.second;
+    }
+}
+
+inline void RadixHeap::insert(int x) {
+    push(x);
+    live++;
+}
+
+inline void RadixHeap::decreaseKey(int x) {
+    push(x);
+}
+
+#endif /* DA_TP_CLASSES_RADIXHEAP */
@@ -0,0 +1,251 @@
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "AvoidMask.h"
+#include "HierarchyMetric.h"
+#include "SearchEngines.h"
+#include "WalkTreeCache.h"
+
+#ifndef INF
+#define INF std::numeric_limits<double>::max()
+#endif
+
+/**
+ * @brief Per-query state used by the route searches.
+ *
+ * @details Every array is indexed by the dense vertex index or by the edge id of the CSRGraph, so the
+ * search loop touches contiguous memory only. Paths are stored as the id of the edge used to reach a
+ * vertex (-1 if none).
+ * The Graph is never written during a query: all the state lives here, so several queries can run
+ * concurrently on the same Graph as long as each one uses its own SearchContext. A context can be reused
+ * for any number of queries and it is resized automatically when used with another graph. The engines and
+ * the walk tree cache are not part of it: they are shared by every context that points to them.
+ *
+ * Distances, paths and the visited flags are epoch-stamped: an entry only counts if its stamp matches the
+ * current epoch, otherwise it reads as INF / no path / not visited. Resetting them is a single increment,
+ * so a query only pays for the vertices it actually reaches.
+ */
+struct SearchContext {
+    /**
+     * @brief Distances and paths of one mode of travel.
+     */
+    struct Layer {
+        std::vector<double> dist;      ///< Distance of each vertex (valid only if stamped).
+        std::vector<int32_t> minutes;  ///< Integer distance of each vertex, only sized by the integer search (fitMinutes()).
+        std::vector<int> path;         ///< Previous edge of each vertex (valid only if stamped).
+        std::vector<unsigned> stamp;   ///< Epoch in which dist and path were last written.
+        unsigned epoch = 1;            ///< Current epoch.
+    };
+
+    Layer drive;                    ///< Distances and paths for driving mode.
+    Layer walk;                     ///< Distances and paths for walking mode.
+    Layer back;                     ///< Distances to the destination and next edges, for bidirectionalDijkstra().
+    std::vector<unsigned> visited;  ///< Epoch in which each vertex was marked as visited.
+    unsigned visitEpoch = 1;        ///< Current visited epoch.
+    AvoidMask avoidNode;            ///< Vertices to avoid, by dense index.
+    AvoidMask avoidEdge;            ///< Edges to avoid, by edge id.
+    std::vector<int> queueIndex;    ///< Heap positions, required by IndexedPriorityQueue and DaryHeap.
+    std::vector<int> backQueueIndex;  ///< Heap positions of the backward queue of bidirectionalDijkstra().
+    std::vector<double> estimate;   ///< Queue keys of altDijkstra(): distance plus the landmark lower bound.
+    std::vector<double> penalty;    ///< Factor of the time of each edge in alternativeRoutes() (1 outside of it).
+    HierarchyMetric metric;         ///< Metric of the customizable hierarchy for the restrictions of the current query.
+    const SearchEngines *engines;   ///< Engines and options of the queries (shared, never null).
+    WalkTreeCache *walkTrees;       ///< Walking trees of recent DrivingWalking destinations (shared, null for none).
+
+    /**
+     * @brief Creates an empty context, sized by the first query.
+     *
+     * @param engines The engines and options of the queries; the default one runs every query with dijkstra(...).
+     * @param walkTrees The cache of walking trees, or nullptr to search them every time.
+     */
+    explicit SearchContext(const SearchEngines &engines = defaultEngines(), WalkTreeCache *walkTrees = nullptr)
+        : engines(&engines), walkTrees(walkTrees) {}
+
+    /**
+     * @brief Gets the engines and options used when none are given.
+     *
+     * @return A default SearchEngines.
+     */
+    static const SearchEngines &defaultEngines() {
+        static const SearchEngines engines;
+        return engines;
+    }
+
+    /**
+     * @brief Sizes every array for a graph and resets it to the initial state.
+     *
+     * @param n Number of vertices.
+     * @param m Number of edges.
+     */
+    void resize(int n, int m) {
+        for (Layer *l : {&drive, &walk, &back}) {
+            l->dist.assign(n, INF);
+            l->minutes.clear();
+            l->path.assign(n, -1);
+            l->stamp.assign(n, 0);
+            l->epoch = 1;
+        }
+        visited.assign(n, 0);
+        visitEpoch = 1;
+        avoidNode.resize(n);
+        avoidEdge.resize(m);
+        queueIndex.assign(n, 0);
+        backQueueIndex.assign(n, 0);
+        estimate.assign(n, INF);
+        penalty.assign(m, 1);
+    }
+
+    /**
+     * @brief Resizes the context if it was not sized for the given graph.
+     *
+     * @param csr The graph the next query will run on.
+     */
+    void fit(const CSRGraph &csr) {
+        if (static_cast<int>(visited.size()) != csr.numVertices() ||
+            avoidEdge.getSize() != csr.numEdges()) {
+            resize(csr.numVertices(), csr.numEdges());
+        }
+    }
+
+    /**
+     * @brief Sizes the integer distances of a layer, which only the integer search reads, so contexts that never
+     * run it do not allocate them.
+     *
+     * @tparam Mode DRIVING or WALKING.
+     */
+    template <int Mode>
+    void fitMinutes() {
+        Layer &l = layer<Mode>();
+        if (l.minutes.size() != l.dist.size()) l.minutes.assign(l.dist.size(), 0);
+    }
+
+    /**
+     * @brief Gets the layer of a mode.
+     *
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     * @return Reference to the layer.
+     */
+    Layer &layer(int mode) { return mode == 0 ? drive : walk; }
+    const Layer &layer(int mode) const { return mode == 0 ? drive : walk; }
+
+    /**
+     * @brief Gets the layer of a mode known at compile time.
+     *
+     * @tparam Mode DRIVING or WALKING.
+     * @return Reference to the layer.
+     */
+    template <int Mode>
+    Layer &layer() {
+        if constexpr (Mode == DRIVING) return drive;
+        else return walk;
+    }
+    template <int Mode>
+    const Layer &layer() const {
+        if constexpr (Mode == DRIVING) return drive;
+        else return walk;
+    }
+
+    /**
+     * @brief Sets every distance of a mode to INF and every path to none.
+     *
+     * @note Time Complexity: O(1) (O(V) once every 2^32 resets, when the epoch wraps around).
+     */
+    void resetDist(int mode) {
+        reset(layer(mode));
+    }
+
+    /**
+     * @brief Sets every distance of a layer to INF and every path to none.
+     *
+     * @param l The layer to reset.
+     *
+     * @note Time Complexity: O(1) (O(V) once every 2^32 resets, when the epoch wraps around).
+     */
+    static void reset(Layer &l) {
+        if (++l.epoch == 0) {
+            std::fill(l.stamp.begin(), l.stamp.end(), 0);
+            l.epoch = 1;
+        }
+    }
+
+    /**
+     * @brief Marks every vertex as not visited.
+     *
+     * @note Time Complexity: O(1) (O(V) once every 2^32 resets, when the epoch wraps around).
+     */
+    void resetVisited() {
+        if (++visitEpoch == 0) {
+            std::fill(visited.begin(), visited.end(), 0);
+            visitEpoch = 1;
+        }
+    }
+
+    double getDist(int u, int mode) const {
+        const Layer &l = layer(mode);
+        return l.stamp[u] == l.epoch ? l.dist[u] : INF;
+    }
+
+    template <int Mode>
+    double getDist(int u) const {
+        const Layer &l = layer<Mode>();
+        return l.stamp[u] == l.epoch ? l.dist[u] : INF;
+    }
+
+    int getPath(int u, int mode) const {
+        const Layer &l = layer(mode);
+        return l.stamp[u] == l.epoch ? l.path[u] : -1;
+    }
+
+    /**
+     * @brief Sets the distance and the previous edge of a vertex.
+     *
+     * @param u The dense index of the vertex.
+     * @param dist The distance to be set.
+     * @param path The id of the edge that precedes the vertex (-1 if none).
+     * @param mode The mode of travel (0 for driving, 1 for walking).
+     */
+    void set(int u, double dist, int path, int mode) {
+        Layer &l = layer(mode);
+        l.dist[u] = dist;
+        l.path[u] = path;
+        l.stamp[u] = l.epoch;
+    }
+
+    template <int Mode>
+    void set(int u, double dist, int path) {
+        Layer &l = layer<Mode>();
+        l.dist[u] = dist;
+        l.path[u] = path;
+        l.stamp[u] = l.epoch;
+    }
+
+    /**
+     * @brief Sets the distance and the previous edge of a vertex, for the integer search.
+     *
+     * @param u The dense index of the vertex.
+     * @param minutes The distance to be set.
+     * @param path The id of the edge that precedes the vertex (-1 if none).
+     * @tparam Mode DRIVING or WALKING.
+     */
+    template <int Mode>
+    void setMinutes(int u, int32_t minutes, int path) {
+        Layer &l = layer<Mode>();
+        l.minutes[u] = minutes;
+        l.dist[u] = minutes;
+        l.path[u] = path;
+        l.stamp[u] = l.epoch;
+    }
+
+    bool isVisited(int u) const { return visited[u] == visitEpoch; }
+
+    void setVisited(int u) { visited[u] = visitEpoch; }
+
+    void clearVisited(int u) { visited[u] = 0; }
+};
+
+#endif //SEARCHCONTEXT_H
@@ -0,0 +1,53 @@
+#ifndef SEARCHENGINES_H
+#define SEARCHENGINES_H
+
+class LandmarkTable;
+class ContractionHierarchy;
+class CustomizableHierarchy;
+
+/**
+ * @brief Priority queues that dijkstra() can run on.
+ */
+enum class QueueKind {
+    Binary, ///< IndexedPriorityQueue: binary heap of indices.
+    Dary,   ///< DaryHeap: 4-ary heap of (key, index) pairs.
+    Radix,  ///< RadixHeap: monotone radix heap.
+    Bucket  ///< BucketQueue over integer times (Dial's algorithm); the binary heap if the graph is not integral.
+};
+
+/**
+ * @brief Priority queue used by each query type.
+ *
+ * @details Every queue returns the same distances, but when several routes are equally fast the order in
+ * which tied vertices leave the queue decides which one is reported (and, in DrivingWalking, which parking
+ * spot wins a tie). The binary heap is the default, since only it reports the routes of the original searches;
+ * the bucket queue is chosen only when asked for, even on integral graphs.
+ */
+struct QueuePolicy {
+    QueueKind simpleDriving = QueueKind::Binary;      ///< Used by SimpleDriving.
+    QueueKind restrictedDriving = QueueKind::Binary;  ///< Used by RestrictedDriving.
+    QueueKind drivingWalking = QueueKind::Binary;     ///< Used by DrivingWalking and its alternatives.
+};
+
+/**
+ * @brief Engines and options of the route queries.
+ *
+ * @details It is only read during a query, so any number of SearchContexts (one per thread) can share it. The
+ * engines are not owned and must outlive the queries that use them. When several engines are set, the first one
+ * that applies is used:
+ * - best route of SimpleDriving: the all-pairs matrices of the graph, hierarchy, then the point-to-point search;
+ * - RestrictedDriving: customizable, then the point-to-point search;
+ * - point-to-point search (also the alternative of SimpleDriving): landmarks, bidirectional, then dijkstra(...)
+ *   with the queue of the query type;
+ * - parking spot of DrivingWalking: the matrices (without restrictions), singlePassParking, then the two dijkstras.
+ */
+struct SearchEngines {
+    QueuePolicy queues;                               ///< Priority queue used by each query type.
+    bool bidirectional = false;                       ///< Whether the point-to-point search is bidirectionalDijkstra().
+    bool singlePassParking = false;                   ///< Whether DrivingWalking finds the parking spot with parkingSearch().
+    const LandmarkTable *landmarks = nullptr;         ///< If set, the point-to-point search is altDijkstra().
+    const ContractionHierarchy *hierarchy = nullptr;  ///< If set (for driving), SimpleDriving finds its best route with it.
+    const CustomizableHierarchy *customizable = nullptr;  ///< If set, RestrictedDriving finds its routes with it.
+};
+
+#endif //SEARCHENGINES_H
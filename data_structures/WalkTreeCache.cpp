@@ -0,0 +1,125 @@
+#include "WalkTreeCache.h"
+#include "SearchContext.h"
+
+#include <algorithm>
+
+std::size_t WalkTreeCache::KeyHash::operator()(const Key &k) const {
+    // FNV-1a over the fields
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](uint64_t x) {
+        h ^= x;
+        h *= 1099511628211ULL;
+    };
+    mix(static_cast<uint32_t>(k.dest));
+    mix(static_cast<uint32_t>(k.queue));
+    for (int v : k.avoidNodes) mix(static_cast<uint32_t>(v));
+    mix(UINT64_MAX); // separator, so {a},{b} and {a,b},{} differ
+    for (int e : k.avoidEdges) mix(static_cast<uint32_t>(e));
+    return static_cast<std::size_t>(h);
+}
+
+void WalkTreeCache::setCapacity(const std::size_t vertices) {
+    std::lock_guard lock(mutex);
+    capacity = vertices;
+    evict();
+}
+
+std::size_t WalkTreeCache::getCapacity() const {
+    std::lock_guard lock(mutex);
+    return capacity;
+}
+
+void WalkTreeCache::clear() {
+    std::lock_guard lock(mutex);
+    trees.clear();
+    index.clear();
+    size = 0;
+    graph = 0;
+}
+
+WalkTreeCache::Key WalkTreeCache::makeKey(const SearchContext &ctx, const int dest, const QueueKind queue) {
+    Key key{dest, static_cast<int>(queue), ctx.avoidNode.getSetBits(), ctx.avoidEdge.getSetBits()};
+    std::sort(key.avoidNodes.begin(), key.avoidNodes.end());
+    std::sort(key.avoidEdges.begin(), key.avoidEdges.end());
+    return key;
+}
+
+void WalkTreeCache::evict() {
+    while (size > capacity && !trees.empty()) {
+        size -= trees.back().nodes.size();
+        index.erase(trees.back().key);
+        trees.pop_back();
+    }
+}
+
+bool WalkTreeCache::restore(const CSRGraph &csr, SearchContext &ctx, const int dest, const double maxWalkTime,
+                            const QueueKind queue) {
+    std::lock_guard lock(mutex);
+    if (capacity == 0 || graph == 0 || graph != csr.getVersion())
+        return false;
+    auto it = index.find(makeKey(ctx, dest, queue));
+    if (it == index.end() || it->second->bound < maxWalkTime)
+        return false;
+    trees.splice(trees.begin(), trees, it->second);
+    const Tree &tree = *it->second;
+
+    // The vertices within the bound keep their labels; the search would have settled exactly those
+    ctx.resetDist(WALKING);
+    for (const Node &node : tree.nodes) {
+        if (node.dist <= maxWalkTime) ctx.set<WALKING>(node.vertex, node.dist, node.path);
+    }
+
+    // It would also have relaxed their edges once, leaving these labels on the vertices just outside the bound
+    const SearchContext::Layer &walk = ctx.walk;
+    for (const Node &node : tree.nodes) {
+        if (node.dist > maxWalkTime) continue;
+        for (int e : csr.edges(node.vertex)) {
+            if (ctx.avoidEdge.test(e) || csr.walk(e) == -1) continue;
+            const int w = csr.target(e);
+            if (ctx.avoidNode.test(w)) continue;
+            if (walk.stamp[w] == walk.epoch && walk.dist[w] <= maxWalkTime) continue;
+            if (node.dist + csr.walk(e) < ctx.getDist<WALKING>(w)) ctx.set<WALKING>(w, node.dist + csr.walk(e), e);
+        }
+    }
+    return true;
+}
+
+void WalkTreeCache::store(const CSRGraph &csr, const SearchContext &ctx, const int dest, const double maxWalkTime,
+                          const QueueKind queue) {
+    // The settled vertices form the tree of the previous edges under the bound, so it is walked from the root;
+    // it is read from the context before taking the lock
+    Tree tree{makeKey(ctx, dest, queue), maxWalkTime, {}};
+    auto settled = [&](int v) { return ctx.getDist<WALKING>(v) <= maxWalkTime; };
+    if (settled(dest)) tree.nodes.push_back({dest, -1, 0});
+    for (std::size_t i = 0; i < tree.nodes.size(); i++) {
+        const int v = tree.nodes[i].vertex;
+        for (int e : csr.edges(v)) {
+            const int w = csr.target(e);
+            if (w != dest && ctx.walk.path[w] == e && ctx.walk.stamp[w] == ctx.walk.epoch && settled(w))
+                tree.nodes.push_back({w, e, ctx.getDist<WALKING>(w)});
+        }
+    }
+
+    std::lock_guard lock(mutex);
+    if (capacity == 0)
+        return;
+    if (graph != csr.getVersion()) {
+        trees.clear();
+        index.clear();
+        size = 0;
+        graph = csr.getVersion();
+    }
+    if (tree.nodes.size() > capacity)
+        return;
+
+    auto it = index.find(tree.key);
+    if (it != index.end()) {
+        size -= it->second->nodes.size();
+        trees.erase(it->second);
+        index.erase(it);
+    }
+    size += tree.nodes.size();
+    trees.push_front(std::move(tree));
+    index.emplace(trees.front().key, trees.begin());
+    evict();
+}
@@ -0,0 +1,127 @@
+#ifndef WALKTREECACHE_H
+#define WALKTREECACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "CSRGraph.h"
+
+struct SearchContext;
+enum class QueueKind;
+
+/**
+ * @brief LRU cache of the walking trees that DrivingWalking grows from its destinations.
+ *
+ * @details A tree is kept as the vertices its walking dijkstra settled (those within the walk bound), with their
+ * distances and previous edges, and it is keyed by the destination, the avoided vertices and edges and the priority
+ * queue (which decides the tree when routes tie). A tree grown with a larger bound also serves smaller ones: the
+ * vertices within the new bound are exactly the ones that search would settle, with the same labels, and the labels
+ * it would leave just outside the bound are recomputed from their edges. So a restored walking layer is the same as
+ * the one the search would leave, and results do not change.
+ * The size of the cache is counted in stored vertices; the least recently used trees are dropped first.
+ * One cache is shared by the SearchContexts that point to it, possibly on several threads: every operation holds
+ * a lock, and the tree is copied into the context of the caller.
+ */
+class WalkTreeCache {
+public:
+    /**
+     * @brief Sets the maximum number of vertices kept over all the trees; 0 disables the cache.
+     *
+     * @param vertices The capacity, in vertices.
+     */
+    void setCapacity(std::size_t vertices);
+
+    /**
+     * @brief Gets the maximum number of vertices kept over all the trees.
+     *
+     * @return The capacity, in vertices.
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     * @brief Drops every tree. Trees of another version of the graph are dropped anyway (see CSRGraph::getVersion()).
+     */
+    void clear();
+
+    /**
+     * @brief Restores a tree into the walking layer, if one that covers the bound is cached.
+     *
+     * @param csr The graph.
+     * @param ctx The search context, with the restrictions of the query already set; its walking layer is replaced.
+     * @param dest The dense index of the destination.
+     * @param maxWalkTime The walk bound of the query.
+     * @param queue The priority queue the walking dijkstra would use.
+     * @return True if the tree was restored, false if it has to be searched.
+     *
+     * @note Time Complexity: O(k + d) where k is the number of vertices within the bound and d their degree.
+     */
+    bool restore(const CSRGraph &csr, SearchContext &ctx, int dest, double maxWalkTime, QueueKind queue);
+
+    /**
+     * @brief Stores the tree that a walking dijkstra from dest, bounded by maxWalkTime, just left in the walking layer.
+     *
+     * @param csr The graph.
+     * @param ctx The search context, with the same restrictions as the search.
+     * @param dest The dense index of the destination.
+     * @param maxWalkTime The walk bound of the search.
+     * @param queue The priority queue the search used.
+     *
+     * @note Time Complexity: O(k + d) where k is the number of vertices in the tree and d their degree.
+     */
+    void store(const CSRGraph &csr, const SearchContext &ctx, int dest, double maxWalkTime, QueueKind queue);
+
+private:
+    /**
+     * @brief What a tree depends on.
+     */
+    struct Key {
+        int dest;
+        int queue;
+        std::vector<int> avoidNodes;  ///< Sorted dense indices.
+        std::vector<int> avoidEdges;  ///< Sorted edge ids.
+        bool operator==(const Key &o) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &k) const;
+    };
+
+    /**
+     * @brief A vertex of a tree.
+     */
+    struct Node {
+        int vertex;
+        int path;     ///< Previous edge, -1 for the destination.
+        double dist;  ///< Walking time from the destination.
+    };
+
+    /**
+     * @brief A cached tree.
+     */
+    struct Tree {
+        Key key;
+        double bound;             ///< Walk bound it was grown with.
+        std::vector<Node> nodes;  ///< Vertices within the bound, parents before children.
+    };
+
+    /**
+     * @brief Builds the key of the current query.
+     */
+    static Key makeKey(const SearchContext &ctx, int dest, QueueKind queue);
+
+    /**
+     * @brief Drops least recently used trees until the size fits the capacity.
+     */
+    void evict();
+
+    std::size_t capacity = std::size_t(1) << 20;  ///< Maximum number of vertices kept.
+    std::size_t size = 0;                         ///< Number of vertices kept.
+    std::uint64_t graph = 0;                      ///< Version of the graph the trees were grown on (0 if none).
+    std::list<Tree> trees;                        ///< Most recently used first.
+    std::unordered_map<Key, std::list<Tree>::iterator, KeyHash> index;  ///< Trees by key.
+    mutable std::mutex mutex;                     ///< Held by every public operation.
+};
+
+#endif //WALKTREECACHE_H
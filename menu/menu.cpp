@@ -1,6 +1,9 @@
 #include "menu.h"
 #include "tc.h"
 #include "../algorithms/Algorithms.h"
+#include "../algorithms/AlternativeRoutes.h"
+#include "../algorithms/DistanceTable.h"
+#include "../data_structures/GraphSnapshot.h"
 
 #include <fstream>
 #include <sstream>
@@ -21,14 +24,15 @@ using namespace std;
 //Menu
 
 Menu::Menu() : selectedItemIndex(0), currentColor(TC_MAG),
-    graph(initialize("../data/loc.csv", "../data/dist.csv")),
     items({
         "1. Plan Route",
         "2. Plan Green Route",
         "3. Batch Mode",
         "4. Option",
         "0. Exit"
-    }) {}
+    }) {
+    loadDataSet("../data/loc.csv", "../data/dist.csv");
+}
 
 void Menu::displayMenu() const {
     tc_clear_screen();
@@ -141,6 +145,22 @@ unordered_set<int> parseNodeIds(const string& input,  vector<string>& errors) {
     return nodeIds;
 }
 
+vector<int> parseNodeList(const string& input,  vector<string>& errors) {
+    vector<int> nodeIds;
+    stringstream ss(input);
+    string nodeId;
+    while (getline(ss, nodeId, ',')) {
+        try {
+            nodeIds.push_back(stoi(nodeId));
+        } catch (const invalid_argument& e) {
+            errors.emplace_back("Invalid node ID '" + nodeId + "' skipped.");
+        } catch (const out_of_range& e) {
+            errors.emplace_back("Node ID out of range '" + nodeId + "' skipped.");
+        }
+    }
+    return nodeIds;
+}
+
 vector<pair<int, int>> parseSegmentPairs(const string& input,  vector<string>& errors) {
     vector<pair<int, int>> segments;
     //NOTE: strict regex for a pair of ints and R as raw string
@@ -202,7 +222,7 @@ void Menu::batchProcess() {
         return; // Exit if file cannot be opened
     }
 
-    string line, mode, temp;
+    string line, mode, temp, sourceList, destinationList;
     int source, destination;
 
     // Read the first line for mode
@@ -211,17 +231,18 @@ void Menu::batchProcess() {
 
     // Read the second line for source
     if (!getline(inputFile, line) || line.find("Source:")!=0) errors.emplace_back("Missing or malformed Source line");
-    else try {source = stoi(line.substr(7));}catch (...) {errors.emplace_back("Invalid Source ID");}
+    else try {sourceList = line.substr(7); source = stoi(sourceList);}catch (...) {errors.emplace_back("Invalid Source ID");}
 
     // Read the third line for destination
     if (!getline(inputFile, line) || line.find("Destination:")!=0) errors.emplace_back("Missing or malformed Destination line");
-    else try {destination = stoi(line.substr(12));} catch (...) {errors.emplace_back("Invalid Destination ID");}
+    else try {destinationList = line.substr(12); destination = stoi(destinationList);} catch (...) {errors.emplace_back("Invalid Destination ID");}
 
 
     unordered_set<int> avoidNodes;
     vector<pair<int, int>> avoidEdges;
     int includeNode = -1;
     int maxWalkTime = 0;
+    int k = 2;
 
 
     // Read optional parameters
@@ -236,18 +257,34 @@ void Menu::batchProcess() {
         } else if (line.find("MaxWalkTime:") != string::npos) {
             string value = line.substr(12);
             if (!value.empty()) {try {maxWalkTime = stoi(line.substr(12));} catch (...) {errors.emplace_back("Invalid MaxWalkTime value");}}
+        } else if (line.find("K:") == 0) {
+            string value = line.substr(2);
+            if (!value.empty()) {try {k = stoi(value);} catch (...) {errors.emplace_back("Invalid K value");}}
         }
     }
 
+    // In the table modes, Source and Destination are comma-separated lists (the first ids are source and destination)
+    const bool table = mode == "table" || mode == "table-walking";
+    vector<int> sources, destinations;
+    if (table) {
+        sources = parseNodeList(sourceList, errors);
+        destinations = parseNodeList(destinationList, errors);
+    }
+
     if (includeNode == -1) {includeNode= source;}
-    if (mode != "driving" && mode != "driving-walking") errors.push_back("Unsupported mode: " + mode);
+    if (k < 1) errors.emplace_back("K must be at least 1");
+    if (mode != "driving" && mode != "driving-walking" && mode != "driving-alternatives" && !table) errors.push_back("Unsupported mode: " + mode);
+    if (table && (!avoidNodes.empty() || !avoidEdges.empty())) errors.emplace_back("In mode " + mode + " nodes and segments can not be avoided");
     if (mode == "driving-walking" && source == destination) errors.emplace_back("In mode driving-walking source can not be the same as destination");
+    if (mode == "driving-alternatives" && source == destination) errors.emplace_back("In mode driving-alternatives source can not be the same as destination");
     if (mode == "driving-walking" && (isParkingNode(graph, source) || isParkingNode(graph, destination))) errors.emplace_back("In mode driving-walking neither source or destination can be parking spots");
 
     if (!graph.findVertex(source)) errors.emplace_back("Source node ID " + to_string(source) + " not found in the graph.");
     if (!graph.findVertex(destination)) errors.emplace_back("Destination node ID " + to_string(destination) + " not found in the graph.");
     if (includeNode != source && !graph.findVertex(includeNode)) errors.emplace_back("IncludeNode ID " + to_string(includeNode) + " not found in the graph.");
     for (int nodeId : avoidNodes) if (!graph.findVertex(nodeId)) errors.emplace_back("AvoidNode ID " + to_string(nodeId) + " not found in the graph.");
+    for (size_t i = 1; i < sources.size(); i++) if (!graph.findVertex(sources[i])) errors.emplace_back("Source node ID " + to_string(sources[i]) + " not found in the graph.");
+    for (size_t i = 1; i < destinations.size(); i++) if (!graph.findVertex(destinations[i])) errors.emplace_back("Destination node ID " + to_string(destinations[i]) + " not found in the graph.");
 
     //Display and return if error where found
     if (!errors.empty()) {
@@ -263,11 +300,23 @@ void Menu::batchProcess() {
 
     string routeDetails;
     if (mode == "driving" && avoidNodes.empty() && avoidEdges.empty()) {
-        routeDetails = SimpleDriving(&graph, source, destination);
+        routeDetails = SimpleDriving(&graph, searchContext, source, destination);
     } else if (mode == "driving") {
-        routeDetails = RestrictedDriving(&graph, source, destination, avoidNodes, avoidEdges, includeNode);
+        routeDetails = RestrictedDriving(&graph, searchContext, source, destination, avoidNodes, avoidEdges, includeNode);
     } else if (mode == "driving-walking") {
-        routeDetails = DrivingWalking(&graph, source, destination, maxWalkTime, avoidNodes, avoidEdges);
+        routeDetails = DrivingWalking(&graph, searchContext, source, destination, maxWalkTime, avoidNodes, avoidEdges, k);
+    } else if (mode == "driving-alternatives") {
+        routeDetails = DrivingAlternatives(&graph, searchContext, source, destination, k, avoidNodes, avoidEdges);
+    } else if (mode == "table") {
+        ostringstream times;
+        if (!hierarchy.isBuilt()) hierarchy.build(graph.getCSR());
+        computeTable(&graph, searchContext, hierarchy, sources, destinations).writeCsv(times);
+        routeDetails = times.str();
+    } else if (mode == "table-walking") {
+        ostringstream times;
+        if (!walkingHierarchy.isBuilt()) walkingHierarchy.build(graph.getCSR(), WALKING);
+        computeTable(&graph, searchContext, walkingHierarchy, sources, destinations).writeCsv(times);
+        routeDetails = times.str();
     }
 
     // Write the routing details to the output file
@@ -457,9 +506,9 @@ void Menu::askForRouteDetailsDriving() {
 
     string routeDetails;
     if (avoidNodes.empty() && avoidEdges.empty()) {
-        routeDetails = SimpleDriving(&graph, source, destination);
+        routeDetails = SimpleDriving(&graph, searchContext, source, destination);
     } else {
-        routeDetails = RestrictedDriving(&graph, source, destination, avoidNodes, avoidEdges, includeNode);
+        routeDetails = RestrictedDriving(&graph, searchContext, source, destination, avoidNodes, avoidEdges, includeNode);
     }
 
     hide_cursor();
@@ -649,7 +698,7 @@ void Menu::askForRouteDetailsDW() {
     }
 
     // Execute route algorithm
-    string routeDetails = DrivingWalking(&graph, source, destination, maxWalkTime, avoidNodes, avoidEdges);
+    string routeDetails = DrivingWalking(&graph, searchContext, source, destination, maxWalkTime, avoidNodes, avoidEdges);
 
     hide_cursor();
     enable_raw_mode();
@@ -668,6 +717,10 @@ void Menu::optionsMenu() {
         "1. Change Data Set",
         "2. Change Text Color",
         "3. Help",
+        "4. Precompute Routes",
+        "5. Priority Queue",
+        "6. Search Engine",
+        "7. Parking Search",
         "0. Return to Menu"
     };
 
@@ -692,6 +745,10 @@ void Menu::optionsMenu() {
             case '1':
             case '2':
             case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
                 // Set the index based on the numeric key pressed and execute the selection immediately.
                 optionsIndex = input - '1';
                 handleOptionsSelection(optionsIndex);
@@ -700,7 +757,7 @@ void Menu::optionsMenu() {
                 processArrowKeyInput(optionsIndex, optionsItems.size());
                 break;
             case '\n':// Enter key
-                if (optionsIndex == 3) {optionsRunning = false;}
+                if (optionsIndex == static_cast<int>(optionsItems.size()) - 1) {optionsRunning = false;}
                 handleOptionsSelection(optionsIndex);
                 break;
             default:
@@ -721,6 +778,18 @@ void Menu::handleOptionsSelection(int index) {
         case 2:
             displayHelp();
             break;
+        case 3:
+            precomputeRoutes();
+            break;
+        case 4:
+            changePriorityQueue();
+            break;
+        case 5:
+            changeSearchEngine();
+            break;
+        case 6:
+            changeParkingSearch();
+            break;
         default:
             break;
     }
@@ -779,6 +848,122 @@ void Menu::changeTextColor() {
     }
 }
 
+void Menu::changePriorityQueue() {
+    const vector<string> queueOptions = {"Binary Heap", "4-ary Heap", "Radix Heap", "Bucket Queue"};
+    const vector<QueueKind> queueKinds = {QueueKind::Binary, QueueKind::Dary, QueueKind::Radix, QueueKind::Bucket};
+    int queueChoice = 0;
+
+    while (true) {
+        tc_clear_screen();
+        cout << "Select the priority queue of the searches:\n";
+        for (size_t i = 0; i < queueOptions.size(); ++i) {
+            if (i == static_cast<size_t>(queueChoice)){
+                cout << "> " << queueOptions[i] << "\n";
+            } else {
+                cout << "  " << queueOptions[i] << "\n";
+            }
+        }
+
+        switch (getchar()) {
+            case '\033': // ESC sequence for arrow keys
+                processArrowKeyInput(queueChoice, queueOptions.size());
+                break;
+            case '\n': // Enter key
+                engines.queues = {queueKinds[queueChoice], queueKinds[queueChoice], queueKinds[queueChoice]};
+                displayMenu();
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void Menu::changeSearchEngine() {
+    const vector<string> engineOptions = {"Dijkstra", "Bidirectional Dijkstra", "A* with Landmarks (ALT)",
+                                          "Contraction Hierarchies"};
+    int engineChoice = 0;
+
+    while (true) {
+        tc_clear_screen();
+        cout << "Select the search engine of the driving routes:\n";
+        for (size_t i = 0; i < engineOptions.size(); ++i) {
+            if (i == static_cast<size_t>(engineChoice)){
+                cout << "> " << engineOptions[i] << "\n";
+            } else {
+                cout << "  " << engineOptions[i] << "\n";
+            }
+        }
+
+        switch (getchar()) {
+            case '\033': // ESC sequence for arrow keys
+                processArrowKeyInput(engineChoice, engineOptions.size());
+                break;
+            case '\n': // Enter key
+                // Only one engine is set at a time, so the precedence among them (see SearchEngines) never applies
+                engines.bidirectional = engineChoice == 1;
+                engines.landmarks = nullptr;
+                engines.hierarchy = nullptr;
+                engines.customizable = nullptr;
+                if (engineChoice == 2) {
+                    landmarks = loadLandmarks(graph, locationsFile);
+                    engines.landmarks = &landmarks;
+                } else if (engineChoice == 3) {
+                    if (!hierarchy.isBuilt()) hierarchy.build(graph.getCSR());
+                    if (!customizable.isBuilt()) customizable.build(graph.getCSR());
+                    engines.hierarchy = &hierarchy;
+                    engines.customizable = &customizable;
+                }
+                displayMenu();
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void Menu::changeParkingSearch() {
+    const vector<string> parkingOptions = {"Two Searches", "Single Pass"};
+    int parkingChoice = 0;
+
+    while (true) {
+        tc_clear_screen();
+        cout << "Select how driving-walking routes find their parking spot:\n";
+        for (size_t i = 0; i < parkingOptions.size(); ++i) {
+            if (i == static_cast<size_t>(parkingChoice)){
+                cout << "> " << parkingOptions[i] << "\n";
+            } else {
+                cout << "  " << parkingOptions[i] << "\n";
+            }
+        }
+
+        switch (getchar()) {
+            case '\033': // ESC sequence for arrow keys
+                processArrowKeyInput(parkingChoice, parkingOptions.size());
+                break;
+            case '\n': // Enter key
+                engines.singlePassParking = parkingChoice == 1;
+                displayMenu();
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void Menu::precomputeRoutes() {
+    tc_clear_screen();
+    cout << "Computing the fastest routes between every pair of locations..." << endl;
+    try {
+        graph.computeMatrices();
+        cout << endl << TC_GRN << "Routes precomputed successfully." << TC_NRM << endl;
+        sleep(1);
+    } catch (exception& e) {
+        cout << endl << TC_RED << e.what() << TC_NRM << endl;
+        cout << endl << "Press any key to continue...";
+        getchar();
+    }
+}
+
 void Menu::changeDataSet(){
     const vector<string> dataOptions = {"Normal", "Small", "Custom"};
     int choice = 0;
@@ -804,7 +989,7 @@ void Menu::changeDataSet(){
                 switch (choice) {
                     case 0:
                         try {
-                            graph= initialize("../data/Locations.csv", "../data/Distances.csv");
+                            loadDataSet("../data/Locations.csv", "../data/Distances.csv");
                             cout << endl << TC_GRN << "Dataset loaded successfully." << TC_NRM << endl;
                             sleep(1);
                         }catch (exception& e) {
@@ -815,7 +1000,7 @@ void Menu::changeDataSet(){
                         break;
                     case 1:
                         try{
-                            graph = initialize("../data/loc.csv", "../data/dist.csv");
+                            loadDataSet("../data/loc.csv", "../data/dist.csv");
                             cout << endl << TC_GRN << "Dataset loaded successfully." << TC_NRM << endl;
                             sleep(1);
                         }catch (exception& e) {
@@ -836,7 +1021,7 @@ void Menu::changeDataSet(){
                         hide_cursor();
 
                         try {
-                            graph = initialize(locFile, distFile);
+                            loadDataSet(locFile, distFile);
                             cout << endl << TC_GRN <<  "Custom dataset loaded successfully." << TC_NRM << endl;
                             sleep(1);
                         }catch (exception& e) {
@@ -860,6 +1045,17 @@ void Menu::changeDataSet(){
     }
 }
 
+void Menu::loadDataSet(const std::string &locs, const std::string &dists) {
+    graph = loadGraph(locs, dists);
+    locationsFile = locs;
+    engines = SearchEngines();
+    hierarchy = ContractionHierarchy();
+    walkingHierarchy = ContractionHierarchy();
+    customizable = CustomizableHierarchy();
+    landmarks = LandmarkTable();
+    walkTrees.clear();
+}
+
 void Menu::displayHelp() const {
     vector<string> helpPages = {
         // Page 1: Plan Route
@@ -887,20 +1083,49 @@ void Menu::displayHelp() const {
 3. Batch Mode
    Description: Processes a routing task from a text file input.
    File Format (input.txt):
-     Mode:driving OR Mode:driving-walking
-     Source:<ID>
-     Destination:<ID>
+     Mode:driving OR Mode:driving-walking OR Mode:driving-alternatives
+          OR Mode:table OR Mode:table-walking
+     Source:<ID> (tables: comma-separated list of IDs)
+     Destination:<ID> (tables: comma-separated list of IDs)
      AvoidNodes:1,3,7
      AvoidSegments:(2,3),(4,5)
      IncludeNode:<ID>
      MaxWalkTime:<minutes> (only for driving-walking)
+     K:<count> (driving-walking: approximate routes offered,
+                driving-alternatives: different routes wanted; default 2)
+   Mode table writes the driving times from every source to every
+   destination as CSV (X where there is no route); Mode:table-walking
+   writes the walking times.
    Output is written to: output.txt)",
 
         // Page 4: Options, Exit, Tips
         R"(================================ Help Menu ================================
 4. Options
    - Change Data Set: Load different datasets for routing.
+     A binary snapshot (<locations>.graph) is saved next to the CSV files
+     and reused on later loads while the CSV files are unchanged.
    - Change Text Color: Customize the console text color.
+   - Priority Queue: Choose the queue of the route searches. Every queue
+     finds the same times; equally fast routes may be reported differently.
+     Only the binary heap, the default, reports the same routes as before.
+     Loading a dataset selects it again.
+   - Search Engine: Choose how driving routes are searched: Dijkstra,
+     bidirectional Dijkstra, A* with landmarks, whose table
+     (<locations>.landmarks) is saved next to the CSV files, or contraction
+     hierarchies: a static one for the best route without restrictions and
+     a customizable one for routes with restrictions. Every engine finds
+     the same times; equally fast routes may be reported differently.
+     Loading a dataset selects Dijkstra again.
+   - Parking Search: Choose how green routes find their parking spot: a
+     walking search from the destination followed by a driving search
+     from the source (the default), or a single search that drives, parks
+     and walks, and stops once it reaches the destination. Both find the
+     same total; among parking spots that tie on both driving and walking
+     time they may pick another one. Loading a dataset selects the two
+     searches again.
+   - Precompute Routes: Compute the fastest routes between every pair of
+     locations once, so routes without restrictions are looked up instantly.
+     Takes memory that grows with the square of the number of locations.
 
 5. Exit
    - Closes the application.
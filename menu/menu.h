@@ -3,7 +3,13 @@
 
 #include <vector>
 #include <string>
+#include "../data_structures/ContractionHierarchy.h"
+#include "../data_structures/CustomizableHierarchy.h"
 #include "../data_structures/Graph.h"
+#include "../data_structures/LandmarkTable.h"
+#include "../data_structures/SearchContext.h"
+#include "../data_structures/SearchEngines.h"
+#include "../data_structures/WalkTreeCache.h"
 
 /**
  * @brief Menu class for the Route Planning Tool.
@@ -17,6 +23,14 @@ private:
     int selectedItemIndex;    ///< The index of the currently selected menu item.
     std::string currentColor; ///< The current text color code used for highlighting selections.
     Graph graph;              ///< Graph object containing route and location data.
+    ContractionHierarchy hierarchy; ///< Driving hierarchy of the graph, built when first needed.
+    ContractionHierarchy walkingHierarchy; ///< Walking hierarchy of the graph, built when a walking table is first asked for.
+    LandmarkTable landmarks;  ///< Landmarks of the graph, used by the ALT search engine.
+    CustomizableHierarchy customizable; ///< Customizable hierarchy of the graph, built when first needed.
+    SearchEngines engines;    ///< Engines and options of the route requests.
+    WalkTreeCache walkTrees;  ///< Walking trees of recent driving-walking destinations.
+    SearchContext searchContext{engines, &walkTrees}; ///< Per-query search state reused by every route request.
+    std::string locationsFile; ///< Locations file of the loaded dataset, next to which its landmarks are saved.
     std::vector<std::string> items; ///< List of menu items displayed to the user.
 
 public:
@@ -121,6 +135,54 @@ public:
      */
     void changeDataSet();
 
+    /**
+     * @brief Precomputes the fastest routes between every pair of locations.
+     *
+     * Fills the all-pairs matrices of the graph, which SimpleDriving and DrivingWalking (without
+     * restrictions) then read instead of searching. They are dropped when another dataset is loaded.
+     */
+    void precomputeRoutes();
+
+    /**
+     * @brief Changes the priority queue used by the route searches.
+     *
+     * Allows the user to choose the binary heap, the 4-ary heap, the radix heap or the bucket
+     * queue (which falls back to the binary heap if the times of the graph are not whole numbers).
+     */
+    void changePriorityQueue();
+
+    /**
+     * @brief Changes the search engine of the driving routes.
+     *
+     * Allows the user to choose plain Dijkstra (the default), bidirectional Dijkstra, A* with
+     * landmarks, whose table is read from the file next to the locations file, or computed and
+     * saved there if it is missing or stale, or contraction hierarchies: the static one for the
+     * best route without restrictions and the customizable one for restricted routes. Every engine
+     * finds the same times, but equally fast routes may be reported differently.
+     */
+    void changeSearchEngine();
+
+    /**
+     * @brief Changes how driving-walking routes find their parking spot.
+     *
+     * Allows the user to choose the two searches (walking from the destination, then driving from
+     * the source, the default) or the single search of parkingSearch(...) over a driving and a
+     * walking layer, which stops once the destination is reached.
+     */
+    void changeParkingSearch();
+
+    /**
+     * @brief Loads a dataset into the graph.
+     *
+     * Replaces the graph and resets the engines and the walk tree cache, so nothing computed for
+     * the previous dataset is reused. Every query runs Dijkstra with the binary heap again. No file
+     * but the graph snapshot is written.
+     *
+     * @param locs Path to the locations file.
+     * @param dists Path to the distances file.
+     */
+    void loadDataSet(const std::string &locs, const std::string &dists);
+
     /**
      * @brief Changes the text color of the menu display.
      *
@@ -0,0 +1,660 @@
+// Behaviour checks: every search engine against plain dijkstra on the datasets of data/.
+// Usage: DAProject1Checks   (run from the source directory, as ctest does)
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../algorithms/Algorithms.h"
+#include "../algorithms/AlternativeRoutes.h"
+#include "../algorithms/DistanceTable.h"
+#include "../data_structures/ContractionHierarchy.h"
+#include "../data_structures/CustomizableHierarchy.h"
+#include "../data_structures/GraphSnapshot.h"
+#include "../data_structures/LandmarkTable.h"
+#include "../data_structures/WalkTreeCache.h"
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what) {
+    if (ok) return;
+    if (++failures <= 20) std::cerr << "FAIL: " << what << "\n";
+}
+
+// Nodes and segments avoided by a query
+struct Restrictions {
+    std::unordered_set<int> nodes;
+    std::vector<std::pair<int, int>> segments;
+};
+
+static const std::vector<std::pair<std::string, std::string>> datasets = {
+    {"data/loc.csv", "data/dist.csv"},
+    {"data/extra_loc.csv", "data/extra_dis.csv"},
+    {"data/Locations.csv", "data/Distances.csv"},
+};
+
+// Every pair of ids on the small datasets, an even sample of them on the large one
+static std::vector<std::pair<int, int>> queryPairs(const Graph &g) {
+    const CSRGraph &csr = g.getCSR();
+    const int n = csr.numVertices();
+    const int step = n > 100 ? 23 : 1;
+    std::vector<std::pair<int, int>> res;
+    for (int s = 0; s < n; s += step)
+        for (int t = step / 2; t < n; t += step)
+            if (s != t) res.emplace_back(csr.id(s), csr.id(t));
+    return res;
+}
+
+// Time of a route given as ids, INF if two consecutive ids are not joined by an edge the query may use
+static double routeTime(const Graph &g, const std::vector<int> &ids, int mode, const Restrictions &r) {
+    const CSRGraph &csr = g.getCSR();
+    double total = 0;
+    for (std::size_t i = 1; i < ids.size(); i++) {
+        if (r.nodes.count(ids[i])) return INF;
+        double best = INF;
+        for (int e : csr.edges(g.findVertexIndex(ids[i - 1]))) {
+            if (csr.id(csr.target(e)) != ids[i] || csr.time(e, mode) == -1) continue;
+            bool avoided = false;
+            for (auto [a, b] : r.segments)
+                avoided |= (a == ids[i - 1] && b == ids[i]) || (a == ids[i] && b == ids[i - 1]);
+            if (!avoided && csr.time(e, mode) < best) best = csr.time(e, mode);
+        }
+        if (best == INF) return INF;
+        total += best;
+    }
+    return total;
+}
+
+// The route of plain dijkstra, the reference of every check
+static std::vector<int> reference(const Graph &g, SearchContext &ctx, int origin, int dest, int mode,
+                                  const Restrictions &r, double &time) {
+    initAvoid(&g, ctx, r.nodes, r.segments, mode);
+    dijkstra(&g, ctx, origin, dest, mode, INF); // no walking limit
+    time = 0;
+    return getPath(&g, ctx, origin, dest, time, mode);
+}
+
+// The query without restrictions and, if the engine takes them, avoiding an inner node and the first segment of
+// the fastest route (which forces another route, often one that ties with others)
+static std::vector<Restrictions> restrictionsOf(const Graph &g, SearchContext &ctx, int origin, int dest, int mode,
+                                                bool restricted) {
+    std::vector<Restrictions> res(1);
+    if (!restricted) return res;
+    double time;
+    const std::vector<int> route = reference(g, ctx, origin, dest, mode, {}, time);
+    if (route.size() < 2) return res;
+    if (route.size() > 2) res.push_back({{route[route.size() / 2]}, {}});
+    res.push_back({{}, {{route[0], route[1]}}});
+    return res;
+}
+
+// Whether two CSRs have the same vertices, edges (in the same order, with the same times) and incoming lists
+static bool sameCSR(const CSRGraph &a, const CSRGraph &b) {
+    if (a.numVertices() != b.numVertices() || a.numEdges() != b.numEdges()) return false;
+    for (int u = 0; u < a.numVertices(); u++) {
+        if (a.id(u) != b.id(u) || a.isPark(u) != b.isPark(u) || a.begin(u) != b.begin(u) || a.end(u) != b.end(u) ||
+            !std::ranges::equal(a.incoming(u), b.incoming(u)))
+            return false;
+    }
+    for (int e = 0; e < a.numEdges(); e++) {
+        if (a.source(e) != b.source(e) || a.target(e) != b.target(e) || a.drive(e) != b.drive(e) || a.walk(e) != b.walk(e))
+            return false;
+    }
+    return std::ranges::equal(a.parkingSpots(), b.parkingSpots()) && a.isIntegral() == b.isIntegral() &&
+           (!a.isIntegral() || (a.maxMinutes(DRIVING) == b.maxMinutes(DRIVING) && a.maxMinutes(WALKING) == b.maxMinutes(WALKING)));
+}
+
+// Whether two graphs have the same vertex table and the same reverse links, as positions in the adjacency lists
+static bool sameVertices(const Graph &a, const Graph &b) {
+    if (a.getNumVertex() != b.getNumVertex()) return false;
+    auto position = [](const Edge *edge) {
+        const auto &adj = edge->getOrig()->getAdj();
+        return std::ranges::find(adj, edge) - adj.begin();
+    };
+    for (int u = 0; u < a.getNumVertex(); u++) {
+        const Vertex *v = a.getVertexSet()[u], *w = b.getVertexSet()[u];
+        if (v->getName() != w->getName() || v->getId() != w->getId() || v->getCode() != w->getCode() ||
+            v->isPark() != w->isPark() || v->getAdj().size() != w->getAdj().size())
+            return false;
+        for (std::size_t i = 0; i < v->getAdj().size(); i++) {
+            const Edge *x = v->getAdj()[i], *y = w->getAdj()[i];
+            if ((x->getReverse() == nullptr) != (y->getReverse() == nullptr))
+                return false;
+            if (x->getReverse() != nullptr && (x->getReverse()->getOrig()->getIndex() != y->getReverse()->getOrig()->getIndex() ||
+                                               position(x->getReverse()) != position(y->getReverse())))
+                return false;
+        }
+    }
+    return true;
+}
+
+// The parallel load of the CSV files against the single chunk one (the path taken when a field is quoted) and
+// against the CSR that buildCSR() makes from the vertices
+static void checkParallelLoad(const std::string &locs, const std::string &dists) {
+    const Graph serial = initialize(locs, dists, 1);
+    const Graph parallel = initialize(locs, dists, 4);
+    check(sameCSR(serial.getCSR(), parallel.getCSR()), "initialize " + locs + ": parallel CSR differs from one chunk");
+    CSRGraph rebuilt;
+    rebuilt.build(parallel.getVertexSet());
+    check(sameCSR(rebuilt, parallel.getCSR()), "initialize " + locs + ": CSR differs from the one of its vertices");
+    for (auto v : parallel.getVertexSet())
+        for (auto edge : v->getAdj())
+            check(edge->getReverse() != nullptr && edge->getReverse()->getReverse() == edge,
+                  "initialize " + locs + ": edge without its reverse");
+}
+
+// A snapshot saved from initialize() loads back the same CSR (read in place from the file) and vertex table
+static void checkSnapshot(const std::string &locs, const std::string &dists) {
+    const Graph original = initialize(locs, dists);
+    const std::string path = (std::filesystem::temp_directory_path() / "EngineChecks.graph").string();
+    check(GraphSnapshot::save(original, path, locs, dists), "snapshot " + locs + ": not saved");
+    Graph loaded;
+    check(GraphSnapshot::load(loaded, path, locs, dists), "snapshot " + locs + ": not loaded");
+    std::filesystem::remove(path);
+    check(sameCSR(original.getCSR(), loaded.getCSR()), "snapshot " + locs + ": CSR differs from initialize");
+    check(sameVertices(original, loaded), "snapshot " + locs + ": vertices differ from initialize");
+    const CSRGraph copy = loaded.getCSR();
+    check(sameCSR(copy, loaded.getCSR()), "snapshot " + locs + ": copied CSR differs");
+}
+
+// Runs an engine that leaves its route in the layer of the mode and checks that it is as fast as dijkstra's and is
+// made of edges the query may use. Equally fast routes other than dijkstra's are accepted, and counted as ties
+static void checkEngine(const std::string &name, const Graph &g, int mode, bool restricted,
+                        const std::function<void(SearchContext &, int, int, const Restrictions &)> &engine) {
+    SearchContext ctx, refCtx;
+    int queries = 0, ties = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, mode, restricted)) {
+            double expected;
+            const std::vector<int> best = reference(g, refCtx, origin, dest, mode, r, expected);
+
+            initAvoid(&g, ctx, r.nodes, r.segments, mode);
+            engine(ctx, origin, dest, r);
+            double time = 0;
+            const std::vector<int> route = getPath(&g, ctx, origin, dest, time, mode);
+
+            const std::string query = name + " " + std::to_string(origin) + "->" + std::to_string(dest) +
+                                      " mode " + std::to_string(mode) + " avoiding " +
+                                      std::to_string(r.nodes.size() + r.segments.size());
+            queries++;
+            if (best.empty()) {
+                check(route.empty(), query + ": route found where dijkstra has none");
+                continue;
+            }
+            check(time == expected, query + ": time " + std::to_string(time) + ", dijkstra " + std::to_string(expected));
+            check(routeTime(g, route, mode, r) == expected, query + ": route does not add up to its time");
+            ties += route != best;
+        }
+    }
+    std::cout << name << " (mode " << mode << "): " << queries << " queries, " << ties << " equally fast routes\n";
+}
+
+static void checkBidirectional(const Graph &g) {
+    for (int mode : {DRIVING, WALKING}) {
+        checkEngine("bidirectionalDijkstra", g, mode, true, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+            bidirectionalDijkstra(&g, ctx, origin, dest, mode);
+        });
+    }
+}
+
+// Every priority queue against the binary heap of the reference (the bucket queue runs on the integer times)
+static void checkQueues(const Graph &g) {
+    const std::vector<std::pair<std::string, QueueKind>> queues = {
+        {"DaryHeap", QueueKind::Dary}, {"RadixHeap", QueueKind::Radix}, {"BucketQueue", QueueKind::Bucket}};
+    for (const auto &[name, queue] : queues) {
+        for (int mode : {DRIVING, WALKING}) {
+            checkEngine("dijkstra " + name, g, mode, true, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+                dijkstra(&g, ctx, origin, dest, mode, INF, nullptr, queue);
+            });
+        }
+    }
+}
+
+static void checkLandmarks(const Graph &g) {
+    LandmarkTable landmarks;
+    landmarks.build(g.getCSR(), std::min(LandmarkTable::DEFAULT_COUNT, g.getCSR().numVertices()));
+    for (int mode : {DRIVING, WALKING}) {
+        checkEngine("altDijkstra", g, mode, true, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+            altDijkstra(&g, ctx, landmarks, origin, dest, mode);
+        });
+    }
+}
+
+// The hierarchy has no restrictions, so only the unrestricted queries apply
+static void checkHierarchy(const Graph &g) {
+    ContractionHierarchy hierarchy;
+    hierarchy.build(g.getCSR());
+    checkEngine("hierarchyDijkstra", g, DRIVING, false, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+        hierarchyDijkstra(&g, ctx, hierarchy, origin, dest);
+    });
+}
+
+// The metric is customized for the restrictions of each query, as RestrictedDriving does
+static void checkCustomizable(const Graph &g) {
+    CustomizableHierarchy hierarchy;
+    hierarchy.build(g.getCSR());
+    checkEngine("customizableDijkstra", g, DRIVING, true, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+        hierarchy.customize(g.getCSR(), ctx.metric, ctx.avoidNode, ctx.avoidEdge);
+        customizableDijkstra(&g, ctx, hierarchy, ctx.metric, origin, dest);
+    });
+}
+
+// The parking spot of parkingSearch against the one found from the two dijkstras of DrivingWalking: the fastest
+// total within the walking limit and, among equal totals, the shortest walk
+static void checkParkingSearch(const Graph &g) {
+    const CSRGraph &csr = g.getCSR();
+    SearchContext ctx, refCtx;
+    int queries = 0, parked = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        if (csr.isPark(g.findVertexIndex(origin)) || csr.isPark(g.findVertexIndex(dest))) continue;
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, DRIVING, true)) {
+            for (double maxWalkTime : {10.0, 40.0}) {
+                initAvoid(&g, refCtx, r.nodes, r.segments, WALKING);
+                dijkstra(&g, refCtx, dest, -1, WALKING, maxWalkTime);
+                refCtx.resetDist(DRIVING);
+                dijkstra(&g, refCtx, origin, -1, DRIVING);
+                double bestTotal = INF, bestWalk = INF;
+                for (int p : csr.parkingSpots()) {
+                    const double drive = refCtx.getDist(p, DRIVING), walk = refCtx.getDist(p, WALKING);
+                    if (r.nodes.count(csr.id(p)) || drive == INF || walk > maxWalkTime) continue;
+                    if (drive + walk < bestTotal || (drive + walk == bestTotal && walk < bestWalk)) {
+                        bestTotal = drive + walk;
+                        bestWalk = walk;
+                    }
+                }
+
+                initAvoid(&g, ctx, r.nodes, r.segments, WALKING);
+                const int park = parkingSearch(&g, ctx, origin, dest, maxWalkTime);
+                const std::string query = "parkingSearch " + std::to_string(origin) + "->" + std::to_string(dest) +
+                                          " walking " + std::to_string(maxWalkTime) + " avoiding " +
+                                          std::to_string(r.nodes.size() + r.segments.size());
+                queries++;
+                if (bestTotal == INF) {
+                    check(park == -1, query + ": parking spot found where there is none");
+                    continue;
+                }
+                if (park == -1) {
+                    check(false, query + ": no parking spot found");
+                    continue;
+                }
+                parked++;
+                double drive = 0, walk = 0;
+                const std::vector<int> driveRoute = getPath(&g, ctx, origin, csr.id(park), drive, DRIVING);
+                const std::vector<int> walkRoute = getPath(&g, ctx, dest, csr.id(park), walk, WALKING);
+                check(drive + walk == bestTotal, query + ": total " + std::to_string(drive + walk) + ", expected " +
+                                                     std::to_string(bestTotal));
+                check(walk == bestWalk, query + ": walk " + std::to_string(walk) + ", expected " + std::to_string(bestWalk));
+                check(routeTime(g, driveRoute, DRIVING, r) == drive, query + ": driving route does not add up to its time");
+                check(routeTime(g, walkRoute, WALKING, r) == walk, query + ": walking route does not add up to its time");
+            }
+        }
+    }
+    std::cout << "parkingSearch: " << queries << " queries, " << parked << " with a parking spot\n";
+}
+
+// The output of DrivingWalking from a full walking dijkstra and a driving dijkstra over the whole graph (no cached
+// tree, no pruning), or "" if it has no parking spot within the walk and reports approximate routes instead
+static std::string referenceDrivingWalking(const Graph &g, SearchContext &ctx, int origin, int dest, double maxWalkTime,
+                                           const Restrictions &r) {
+    const CSRGraph &csr = g.getCSR();
+    initAvoid(&g, ctx, r.nodes, r.segments, WALKING);
+    dijkstra(&g, ctx, dest, -1, WALKING, maxWalkTime);
+    initAgain(&g, ctx, DRIVING);
+    int park = g.findVertexIndex(origin);
+    dijkstra(&g, ctx, origin, -1, DRIVING, maxWalkTime, &park);
+    if (csr.id(park) == origin || !csr.isPark(park) || ctx.getDist(park, WALKING) > maxWalkTime) return "";
+
+    std::ostringstream oss;
+    oss << "Source:" << origin << "\nDestination:" << dest << "\nDrivingRoute:";
+    double drive = 0, walk = 0;
+    const std::vector<int> driving = getPath(&g, ctx, origin, csr.id(park), drive, DRIVING);
+    printPath(driving, oss);
+    oss << "(" << drive << ")\nParkingNode:" << driving.back() << "\nWalkingRoute:";
+    std::vector<int> walking = getPath(&g, ctx, dest, csr.id(park), walk, WALKING);
+    std::reverse(walking.begin(), walking.end());
+    printPath(walking, oss);
+    oss << "(" << walk << ")\nTotalTime:" << drive + walk << "\n";
+    return oss.str();
+}
+
+// DrivingWalking, whose driving search stops once no park left can beat the best total, against the reference. The
+// walking trees come from a cache and the larger bound is asked first, so the smaller one is answered by its tree
+static void checkDrivingWalking(const Graph &g) {
+    const CSRGraph &csr = g.getCSR();
+    WalkTreeCache cache;
+    SearchContext ctx(SearchContext::defaultEngines(), &cache), refCtx;
+    int queries = 0, parked = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        if (csr.isPark(g.findVertexIndex(origin)) || csr.isPark(g.findVertexIndex(dest))) continue;
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, DRIVING, true)) {
+            for (double maxWalkTime : {40.0, 10.0}) {
+                const std::string output = DrivingWalking(&g, ctx, origin, dest, maxWalkTime, r.nodes, r.segments);
+                std::string expected = referenceDrivingWalking(g, refCtx, origin, dest, maxWalkTime, r);
+                parked += !expected.empty();
+                if (expected.empty()) {
+                    SearchContext plain;
+                    expected = DrivingWalking(&g, plain, origin, dest, maxWalkTime, r.nodes, r.segments);
+                }
+                queries++;
+                check(output == expected, "DrivingWalking " + std::to_string(origin) + "->" + std::to_string(dest) +
+                                          " walking " + std::to_string(maxWalkTime) + " avoiding " +
+                                          std::to_string(r.nodes.size() + r.segments.size()) + ": got\n" + output +
+                                          "expected\n" + expected);
+            }
+        }
+    }
+    std::cout << "DrivingWalking: " << queries << " queries, " << parked << " with a parking spot\n";
+}
+
+// Two parks with the same total: p (drive 1, walk 3) and q (drive 3, walk 1). The pruned driving search must keep
+// settling parks while one can still tie, so the tie is broken by betterPark(...) as over the whole graph
+static void checkParkingTie() {
+    Graph g;
+    const std::vector<std::pair<std::string, bool>> vertices = {{"o", false}, {"p", true}, {"q", true}, {"t", false}};
+    for (std::size_t i = 0; i < vertices.size(); i++)
+        g.addVertex(vertices[i].first, static_cast<int>(i) + 1, vertices[i].first, vertices[i].second);
+    const std::vector<std::tuple<std::string, std::string, double, double>> segments = {
+        {"o", "p", 10, 1}, {"o", "q", 10, 3}, {"p", "t", 3, -1}, {"q", "t", 1, -1},
+    };
+    for (const auto &[a, b, walk, drive] : segments) g.addBidirectionalEdge(a, b, walk, drive);
+    g.buildCSR();
+
+    SearchContext ctx, refCtx;
+    const std::string output = DrivingWalking(&g, ctx, 1, 4, 5, {}, {});
+    const std::string expected = referenceDrivingWalking(g, refCtx, 1, 4, 5, {});
+    check(!expected.empty() && output == expected, "DrivingWalking on a tie: got\n" + output + "expected\n" + expected);
+    std::cout << "DrivingWalking on a tie: " << output;
+}
+
+// The parking spots of DrivingWalkingAlternatives against the scan over every vertex that the ranking of
+// ParkCandidates replaced: the first is the park of the driving search, the second the best total among the other
+// parks (betterPark(...) by increasing index, so the greater index on equal totals). Also checks that k < 1 throws
+static void checkParkCandidates(const Graph &g) {
+    const CSRGraph &csr = g.getCSR();
+    SearchContext ctx, refCtx;
+    int queries = 0, seconds = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        if (csr.isPark(g.findVertexIndex(origin)) || csr.isPark(g.findVertexIndex(dest))) continue;
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, DRIVING, true)) {
+            initAvoid(&g, refCtx, r.nodes, r.segments, WALKING);
+            dijkstra(&g, refCtx, dest, -1, WALKING, INF);
+            refCtx.resetDist(DRIVING);
+            int firstPark = g.findVertexIndex(origin);
+            dijkstra(&g, refCtx, origin, -1, DRIVING, INF, &firstPark);
+            int secondPark = g.findVertexIndex(origin);
+            for (int v = 0; v < csr.numVertices(); v++) {
+                if (r.nodes.count(csr.id(v)) || !csr.isPark(v) || v == firstPark) continue;
+                secondPark = betterPark(csr, refCtx, secondPark, v, INF) ? secondPark : v;
+            }
+            const bool hasFirst = csr.isPark(firstPark) && refCtx.getDist(firstPark, DRIVING) != INF &&
+                                  refCtx.getDist(firstPark, WALKING) != INF;
+            const bool hasSecond = hasFirst && csr.isPark(secondPark) && refCtx.getDist(secondPark, DRIVING) != INF &&
+                                   refCtx.getDist(secondPark, WALKING) != INF;
+
+            initAvoid(&g, ctx, r.nodes, r.segments, WALKING);
+            std::ostringstream oss;
+            DrivingWalkingAlternatives(&g, ctx, origin, dest, oss, 2);
+            const std::string output = oss.str();
+            auto parkOf = [&](const std::string &name) {
+                const std::size_t at = output.find(name + ":");
+                return at == std::string::npos ? -1 : std::stoi(output.substr(at + name.size() + 1));
+            };
+            const std::string query = "DrivingWalkingAlternatives " + std::to_string(origin) + "->" +
+                                      std::to_string(dest) + " avoiding " + std::to_string(r.nodes.size() + r.segments.size());
+            queries++;
+            check(parkOf("ParkingNode1") == (hasFirst ? csr.id(firstPark) : -1), query + ": first parking spot differs from the scan");
+            check(parkOf("ParkingNode2") == (hasSecond ? csr.id(secondPark) : -1), query + ": second parking spot differs from the scan");
+            seconds += hasSecond;
+        }
+    }
+
+    bool thrown = false;
+    try {
+        std::ostringstream oss;
+        const CSRGraph &graph = g.getCSR();
+        DrivingWalkingAlternatives(&g, ctx, graph.id(0), graph.id(graph.numVertices() - 1), oss, 0);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    check(thrown, "DrivingWalkingAlternatives accepted k = 0");
+    std::cout << "DrivingWalkingAlternatives: " << queries << " queries, " << seconds << " with a second parking spot\n";
+}
+
+// Ids of a route given as edge ids, from the origin
+static std::vector<int> routeIds(const Graph &g, int origin, const std::vector<int> &edges) {
+    std::vector<int> ids = {origin};
+    for (int e : edges) ids.push_back(g.getCSR().id(g.getCSR().target(e)));
+    return ids;
+}
+
+// Ids and time of a route line of the output ("Name:1,2,3(10)"), no ids if it says none
+static std::vector<int> parseRoute(const std::string &output, const std::string &name, double &time) {
+    std::vector<int> ids;
+    const std::size_t at = output.find(name + ":");
+    if (at == std::string::npos) return ids;
+    const std::size_t open = output.find('(', at), end = output.find('\n', at);
+    if (open == std::string::npos || open > end) return ids;
+    std::size_t pos = at + name.size() + 1;
+    while (pos < open) {
+        std::size_t next = std::min(output.find(',', pos), open);
+        ids.push_back(std::stoi(output.substr(pos, next - pos)));
+        pos = next + 1;
+    }
+    time = std::stod(output.substr(open + 1));
+    return ids;
+}
+
+// The disjoint pair: two valid routes that share no inner vertex and no segment, the faster one no faster than
+// dijkstra's and together no slower than the best route and the greedy alternative of SimpleDriving. SimpleDriving
+// itself, which falls back to the pair when it is as fast, must still report dijkstra's time as the best route
+static void checkDisjointRoutes(const Graph &g) {
+    SearchContext ctx, refCtx;
+    int queries = 0, pairs = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, DRIVING, true)) {
+            double fastest;
+            const bool reachable = !reference(g, refCtx, origin, dest, DRIVING, r, fastest).empty();
+
+            initAvoid(&g, ctx, r.nodes, r.segments, DRIVING);
+            std::vector<int> first, second;
+            disjointRoutes(&g, ctx, origin, dest, first, second);
+            const std::vector<int> a = routeIds(g, origin, first), b = routeIds(g, origin, second);
+            const std::string query = "disjointRoutes " + std::to_string(origin) + "->" + std::to_string(dest) +
+                                      " avoiding " + std::to_string(r.nodes.size() + r.segments.size());
+            queries++;
+            check(first.empty() != reachable, query + ": first route does not match dijkstra");
+            if (first.empty()) continue;
+            const double timeA = routeTime(g, a, DRIVING, r);
+            check(timeA >= fastest && timeA != INF, query + ": invalid first route");
+            if (second.empty()) continue;
+            pairs++;
+            const double timeB = routeTime(g, b, DRIVING, r);
+            check(timeB >= timeA && timeB != INF, query + ": invalid second route");
+            std::unordered_set<int> inner(a.begin() + 1, a.end() - 1);
+            for (std::size_t i = 1; i + 1 < b.size(); i++) check(!inner.count(b[i]), query + ": routes share a vertex");
+            if (a.size() == 2 && b.size() == 2) check(false, query + ": routes share the segment");
+
+            if (!r.nodes.empty() || !r.segments.empty()) continue;
+            const std::string output = SimpleDriving(&g, ctx, origin, dest);
+            double best = INF, alternative = INF;
+            const bool direct = parseRoute(output, "BestDrivingRoute", best).size() == 2;
+            const bool greedy = !parseRoute(output, "AlternativeDrivingRoute", alternative).empty();
+            check(best == fastest, query + ": SimpleDriving best route is not the fastest");
+            check(greedy || timeA != fastest, query + ": SimpleDriving found no alternative where an equally fast pair exists");
+            // A direct segment has no inner vertex to mark, so SimpleDriving may take it again
+            check(!greedy || direct || timeA + timeB <= best + alternative, query + ": pair slower than SimpleDriving's routes");
+        }
+    }
+    std::cout << "disjointRoutes: " << queries << " queries, " << pairs << " disjoint pairs\n";
+}
+
+// A graph where the fastest routes s-a-m-w-t and s-a-m-b-t cut t from s, the pair with the lowest total
+// (s-a-c-b-t and s-z-m-w-t, 5 each) is slower than them, and only the fastest route s-a-c-w-t leaves an alternative
+// (s-z-m-b-t). SimpleDriving must still report that pair
+static void checkTightAlternative() {
+    Graph g;
+    const std::vector<std::string> codes = {"s", "a", "z", "c", "m", "w", "b", "t"};
+    for (std::size_t i = 0; i < codes.size(); i++) g.addVertex(codes[i], static_cast<int>(i) + 1, codes[i], false);
+    const std::vector<std::tuple<std::string, std::string, double>> segments = {
+        {"s", "a", 1}, {"s", "z", 2}, {"a", "c", 1}, {"a", "m", 1}, {"z", "m", 1}, {"c", "w", 1},
+        {"m", "w", 1}, {"m", "b", 30}, {"c", "b", 2}, {"w", "t", 1}, {"b", "t", 1},
+    };
+    for (const auto &[a, b, time] : segments) g.addBidirectionalEdge(a, b, time, time);
+    g.buildCSR();
+
+    SearchContext ctx;
+    const std::string output = SimpleDriving(&g, ctx, 1, 8);
+    double best = INF, alternative = INF;
+    const std::vector<int> a = parseRoute(output, "BestDrivingRoute", best);
+    const std::vector<int> b = parseRoute(output, "AlternativeDrivingRoute", alternative);
+    check(best == 4 && routeTime(g, a, DRIVING, {}) == 4, "SimpleDriving on the tight graph: best route is not the fastest");
+    check(alternative == 34 && routeTime(g, b, DRIVING, {}) == 34, "SimpleDriving on the tight graph: no alternative");
+    std::unordered_set<int> inner(a.begin() + 1, a.end() - 1);
+    for (std::size_t i = 1; i + 1 < b.size(); i++) check(!inner.count(b[i]), "SimpleDriving on the tight graph: routes share a vertex");
+    std::cout << "SimpleDriving on the tight graph: " << output;
+}
+
+// The fastest route s-a-b-t (0.3+0.2+0.1, exactly 0.6 in doubles) leaves no alternative; s-a-x-t is just as fast
+// but its times add up to 0.6000000000000001, and it leaves s-y-b-t. SimpleDriving must not tell them apart
+static void checkRoundedAlternative() {
+    Graph g;
+    const std::vector<std::string> codes = {"s", "a", "b", "x", "y", "t"};
+    for (std::size_t i = 0; i < codes.size(); i++) g.addVertex(codes[i], static_cast<int>(i) + 1, codes[i], false);
+    const std::vector<std::tuple<std::string, std::string, double>> segments = {
+        {"s", "a", 0.3}, {"a", "b", 0.2}, {"b", "t", 0.1}, {"a", "x", 0.1}, {"x", "t", 0.2}, {"s", "y", 1}, {"y", "b", 1},
+    };
+    for (const auto &[a, b, time] : segments) g.addBidirectionalEdge(a, b, time, time);
+    g.buildCSR();
+
+    SearchContext ctx;
+    const std::string output = SimpleDriving(&g, ctx, 1, 6);
+    double best = INF, alternative = INF;
+    const std::vector<int> a = parseRoute(output, "BestDrivingRoute", best);
+    const std::vector<int> b = parseRoute(output, "AlternativeDrivingRoute", alternative);
+    check(a == std::vector<int>{1, 2, 4, 6}, "SimpleDriving on rounded times: best route does not leave the alternative");
+    check(b == std::vector<int>{1, 5, 3, 6}, "SimpleDriving on rounded times: no alternative");
+    std::cout << "SimpleDriving on rounded times: " << output;
+}
+
+// The routes of alternativeRoutes: the first as fast as dijkstra's, every one valid, at most 1.5 times slower (its
+// MAX_STRETCH) and sharing at most maxOverlap of its time with the routes before it; the penalties are undone
+static void checkAlternativeRoutes(const Graph &g) {
+    const CSRGraph &csr = g.getCSR();
+    const double maxOverlap = 0.5;
+    SearchContext ctx, refCtx;
+    int queries = 0, routes = 0;
+    for (auto [origin, dest] : queryPairs(g)) {
+        for (const Restrictions &r : restrictionsOf(g, refCtx, origin, dest, DRIVING, true)) {
+            double fastest;
+            const bool reachable = !reference(g, refCtx, origin, dest, DRIVING, r, fastest).empty();
+
+            initAvoid(&g, ctx, r.nodes, r.segments, DRIVING);
+            const std::vector<std::vector<int>> found = alternativeRoutes(&g, ctx, origin, dest, 3, maxOverlap);
+            const std::string query = "alternativeRoutes " + std::to_string(origin) + "->" + std::to_string(dest) +
+                                      " avoiding " + std::to_string(r.nodes.size() + r.segments.size());
+            queries++;
+            check(found.empty() != reachable, query + ": first route does not match dijkstra");
+            std::unordered_set<int> used;
+            for (std::size_t i = 0; i < found.size(); i++) {
+                const double time = routeTime(g, routeIds(g, origin, found[i]), DRIVING, r);
+                double shared = 0;
+                for (int e : found[i]) shared += used.count(e) ? csr.drive(e) : 0;
+                check(time != INF && time <= 1.5 * fastest, query + ": route " + std::to_string(i) + " invalid or too slow");
+                check(i != 0 || time == fastest, query + ": first route is not the fastest");
+                check(shared <= maxOverlap * time, query + ": route " + std::to_string(i) + " overlaps too much");
+                used.insert(found[i].begin(), found[i].end());
+            }
+            routes += static_cast<int>(found.size());
+            bool restored = true;
+            for (double p : ctx.penalty) restored &= p == 1;
+            check(restored, query + ": penalties left on the edges");
+        }
+    }
+    std::cout << "alternativeRoutes: " << queries << " queries, " << routes << " routes\n";
+}
+
+// Every origin and destination of the sample in one table per mode, which must hold dijkstra's times
+static void checkTable(const Graph &g) {
+    std::vector<int> sources, targets;
+    for (auto [origin, dest] : queryPairs(g)) {
+        if (sources.empty() || sources.back() != origin) sources.push_back(origin);
+        if (sources.size() == 1) targets.push_back(dest);
+    }
+    SearchContext ctx, refCtx;
+    ContractionHierarchy hierarchy;
+    for (int mode : {DRIVING, WALKING}) {
+        hierarchy.build(g.getCSR(), mode);
+        const DistanceTable table = computeTable(&g, ctx, hierarchy, sources, targets);
+        check(table.mode == mode, "computeTable: table not in the mode of the hierarchy");
+        for (std::size_t i = 0; i < sources.size(); i++) {
+            for (std::size_t j = 0; j < targets.size(); j++) {
+                double expected;
+                if (reference(g, refCtx, sources[i], targets[j], mode, {}, expected).empty() && sources[i] != targets[j])
+                    expected = INF;
+                check(table.at(static_cast<int>(i), static_cast<int>(j)) == expected,
+                      "computeTable " + std::to_string(sources[i]) + "->" + std::to_string(targets[j]) +
+                      " mode " + std::to_string(mode));
+            }
+        }
+    }
+
+    bool thrown = false;
+    try {
+        computeTable(&g, ctx, hierarchy, {-1}, targets);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    check(thrown, "computeTable accepted an unknown id");
+    std::cout << "computeTable: " << sources.size() << "x" << targets.size() << " tables\n";
+}
+
+// Both ways of filling the matrices; they stay filled afterwards, so this check runs last on a graph
+static void checkMatrices(Graph &g) {
+    for (MatrixMethod method : {MatrixMethod::Dijkstra, MatrixMethod::FloydWarshall}) {
+        g.computeMatrices(method);
+        for (int mode : {DRIVING, WALKING}) {
+            const std::string name = method == MatrixMethod::Dijkstra ? "matrixRoute (Dijkstra)" : "matrixRoute (Floyd-Warshall)";
+            checkEngine(name, g, mode, false, [&](SearchContext &ctx, int origin, int dest, const Restrictions &) {
+                matrixRoute(&g, ctx, origin, dest, mode);
+            });
+        }
+    }
+}
+
+int main() {
+    checkTightAlternative();
+    checkRoundedAlternative();
+    checkParkingTie();
+    for (const auto &[locs, dists] : datasets) {
+        std::cout << locs << "\n";
+        checkParallelLoad(locs, dists);
+        checkSnapshot(locs, dists);
+        Graph g = initialize(locs, dists);
+        checkBidirectional(g);
+        checkQueues(g);
+        checkLandmarks(g);
+        checkHierarchy(g);
+        checkCustomizable(g);
+        checkParkingSearch(g);
+        checkParkCandidates(g);
+        checkDrivingWalking(g);
+        checkDisjointRoutes(g);
+        checkAlternativeRoutes(g);
+        checkTable(g);
+        checkMatrices(g);
+    }
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    std::cout << "All checks passed\n";
+    return 0;
+}